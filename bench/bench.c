@@ -0,0 +1,192 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/resource.h>
+#include "scheduler.h"
+#include "workload_gen.h"
+
+// Throughput benchmark: times every scheduler and calculate_metrics on
+// seeded synthetic workloads of growing size. Schedulers are timed with the
+// streaming metrics accumulator attached, as the CLI runs them.
+
+typedef enum {
+    BENCH_FIFO,
+    BENCH_SJF,
+    BENCH_STCF,
+    BENCH_RR,
+    BENCH_MLFQ,
+    BENCH_CFS,
+    BENCH_LOTTERY,
+    BENCH_STRIDE,
+    BENCH_PRIORITY,
+    BENCH_METRICS,
+    BENCH_COUNT
+} bench_target_t;
+
+static const char *target_names[BENCH_COUNT] = {
+    "FIFO", "SJF", "STCF", "RR", "MLFQ", "CFS", "Lottery", "Stride", "Priority", "metrics"
+};
+
+typedef struct {
+    const char *name;
+    arrival_dist_t arrivals;
+    burst_dist_t bursts;
+} bench_shape_t;
+
+static const bench_shape_t shapes[] = {
+    {"poisson/exp",    ARRIVAL_POISSON, BURST_EXPONENTIAL},
+    {"poisson/pareto", ARRIVAL_POISSON, BURST_PARETO},
+    {"storms/exp",     ARRIVAL_BURSTY,  BURST_EXPONENTIAL},
+};
+#define NUM_SHAPES (int)(sizeof(shapes) / sizeof(shapes[0]))
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Peak resident set size of the whole process so far, in MiB
+static double peak_rss_mib(void) {
+    struct rusage ru;
+    getrusage(RUSAGE_SELF, &ru);
+    return ru.ru_maxrss / 1024.0;
+}
+
+// Runs one target once on a fresh copy of the workload; returns its events
+static long run_target(bench_target_t target, const proc_table_t *workload, proc_table_t *work,
+                       timeline_t *timeline, double *seconds) {
+    static int quantums[] = {2, 4, 8};
+    mlfq_config_t mlfq = {3, quantums, 10};
+    static metrics_acc_t acc;
+    metrics_t metrics;
+    long events = 0;
+
+    proc_table_copy_inputs(work, workload);
+
+    // Metrics are timed on a finished schedule
+    if (target == BENCH_METRICS) {
+        events = schedule_fifo_table(work, timeline, NULL);
+        int total_time = work->completion_time[work->n - 1];
+        double start = now_seconds();
+        calculate_metrics_table(work, total_time, &metrics);
+        *seconds = now_seconds() - start;
+        return events;
+    }
+
+    double start = now_seconds();
+    metrics_acc_init(&acc);
+    switch (target) {
+        case BENCH_FIFO: events = schedule_fifo_table(work, timeline, &acc); break;
+        case BENCH_SJF:  events = schedule_sjf_table(work, timeline, &acc); break;
+        case BENCH_STCF: events = schedule_stcf_table(work, timeline, &acc); break;
+        case BENCH_RR:   events = schedule_rr_table(work, 3, timeline, &acc); break;
+        case BENCH_MLFQ: events = schedule_mlfq_table(work, &mlfq, timeline, &acc); break;
+        case BENCH_CFS:  events = schedule_cfs_table(work, NULL, timeline, &acc); break;
+        case BENCH_LOTTERY: events = schedule_lottery_table(work, 3, 1, timeline, &acc); break;
+        case BENCH_STRIDE: events = schedule_stride_table(work, 3, timeline, &acc); break;
+        case BENCH_PRIORITY: events = schedule_priority_table(work, 1, 100, timeline, &acc); break;
+        default: break;
+    }
+    metrics_acc_finish(&acc, 0, &metrics);
+    *seconds = now_seconds() - start;
+    return events;
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr,
+            "Usage: %s [--min N] [--max N] [--seed S] [--csv]\n"
+            "  Sizes go from --min to --max in powers of ten (default 100 to 10000000).\n"
+            "  Small sizes are repeated until each measurement takes ~0.2 s.\n",
+            prog);
+}
+
+int main(int argc, char *argv[]) {
+    long min_n = 100;
+    long max_n = 10000000;
+    unsigned long long seed = 42;
+    int csv = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--min") == 0 && i + 1 < argc) min_n = atol(argv[++i]);
+        else if (strcmp(argv[i], "--max") == 0 && i + 1 < argc) max_n = atol(argv[++i]);
+        else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) seed = strtoull(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--csv") == 0) csv = 1;
+        else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if (min_n < 1 || max_n < min_n || max_n > 100000000) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    if (csv) printf("size,workload,target,ns_per_job,events,events_per_sec,peak_rss_mib\n");
+    else printf("%10s  %-15s %-8s %12s %12s %14s %12s\n",
+                "jobs", "workload", "target", "ns/job", "events", "events/s", "peak RSS MiB");
+
+    process_t *workload = malloc(sizeof(process_t) * max_n);
+    timeline_t timeline;
+    timeline_init(&timeline);
+    if (!workload) {
+        fprintf(stderr, "Out of memory for %ld jobs\n", max_n);
+        return 1;
+    }
+
+    for (long n = min_n; n <= max_n; n *= 10) {
+        for (int s = 0; s < NUM_SHAPES; s++) {
+            workload_spec_t spec;
+            workload_default_spec(&spec, (int)n, seed);
+            spec.arrivals = shapes[s].arrivals;
+            spec.bursts = shapes[s].bursts;
+            workload_generate(&spec, workload);
+
+            // Schedulers run on the structure-of-arrays table, as the CLI does
+            proc_table_t table, work;
+            if (proc_table_from_array(&table, workload, (int)n) != 0 ||
+                proc_table_init(&work, (int)n) != 0) {
+                fprintf(stderr, "Out of memory for %ld jobs\n", n);
+                return 1;
+            }
+
+            for (int t = 0; t < BENCH_COUNT; t++) {
+                // Report the best of enough repetitions to fill ~0.2 s
+                double best = 1e30, total = 0;
+                long events = 0;
+                int reps = 0;
+                do {
+                    double seconds;
+                    events = run_target((bench_target_t)t, &table, &work, &timeline, &seconds);
+                    if (events < 0) break;
+                    if (seconds < best) best = seconds;
+                    total += seconds;
+                    reps++;
+                } while (total < 0.2 && reps < 1000);
+
+                if (events < 0) {
+                    fprintf(stderr, "%s failed at %ld jobs: out of memory\n", target_names[t], n);
+                    continue;
+                }
+
+                double ns_per_job = best * 1e9 / n;
+                double events_per_sec = best > 0 ? events / best : 0;
+                if (csv) {
+                    printf("%ld,%s,%s,%.2f,%ld,%.0f,%.1f\n", n, shapes[s].name, target_names[t],
+                           ns_per_job, events, events_per_sec, peak_rss_mib());
+                } else {
+                    printf("%10ld  %-15s %-8s %12.2f %12ld %14.0f %12.1f\n", n, shapes[s].name,
+                           target_names[t], ns_per_job, events, events_per_sec, peak_rss_mib());
+                }
+                fflush(stdout);
+            }
+            proc_table_free(&work);
+            proc_table_free(&table);
+        }
+    }
+
+    timeline_free(&timeline);
+    free(workload);
+    return 0;
+}
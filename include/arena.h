@@ -0,0 +1,50 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h>
+
+// Bump allocator for per-run scratch state. Allocation is a pointer bump,
+// individual frees are no-ops, and arena_reset releases everything at once
+// in O(1).
+//
+// A request that does not fit takes an overflow block from the heap. The
+// next reset folds the overflow into one block big enough for the whole
+// previous run, so repeating the same kind of run allocates nothing after
+// the first.
+//
+// Every function also accepts a NULL arena, meaning the C heap: alloc is
+// malloc, release is free, realloc is realloc. Data structures that keep an
+// arena pointer can therefore run either way without separate code paths.
+
+typedef struct arena_block arena_block_t;
+
+typedef struct arena {
+    char *base;                 // Main block
+    size_t size;
+    size_t used;
+    size_t needed;              // Bytes handed out since the reset, overflow included
+    arena_block_t *overflow;    // Blocks taken this run because 'base' was full
+} arena_t;
+
+void arena_init(arena_t *a);
+void arena_free(arena_t *a);
+
+// Makes sure the main block holds at least 'bytes' (only between runs, as it
+// may move the block). Returns 0, or -1 if out of memory.
+int arena_reserve(arena_t *a, size_t bytes);
+
+// Forgets every allocation, keeping the storage
+void arena_reset(arena_t *a);
+
+// 64-byte aligned storage, or NULL if out of memory
+void *arena_alloc(arena_t *a, size_t bytes);
+void *arena_calloc(arena_t *a, size_t count, size_t size);
+
+// Grows 'ptr' (holding 'old_bytes') to 'new_bytes'. On failure returns NULL
+// and 'ptr' stays valid.
+void *arena_realloc(arena_t *a, void *ptr, size_t old_bytes, size_t new_bytes);
+
+// free() for the heap; arena memory is reclaimed by the next reset
+void arena_release(arena_t *a, void *ptr);
+
+#endif // ARENA_H
@@ -0,0 +1,109 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include "scheduler.h"
+
+// Incremental re-simulation. A session runs one policy and records periodic
+// snapshots of the scheduler state. When one process's arrival or burst is
+// edited afterwards, the run resumes from the latest snapshot taken before
+// that process was admitted and before its new arrival time, and the
+// timeline prefix up to there is kept.
+//
+// This is exact: before a process is admitted no policy here looks at
+// anything but its arrival time, so the state at such a snapshot is the
+// same with or without the edit. tests/rerun_test.c checks reruns against
+// fresh runs for every policy.
+
+// Snapshots kept per session. When full, every other one is dropped and the
+// spacing doubles, so memory stays bounded on any trace length.
+#define CHECKPOINT_MAX 64
+
+// One ready job at a snapshot, in queue (or heap array) order
+typedef struct {
+    int idx;
+    int remaining_time;
+    int start_time;
+    int level;              // MLFQ: level list the job is queued in
+    int priority;           // MLFQ: level the job is at
+    int slice_used;         // MLFQ: quantum used at that level
+    int stale;              // MLFQ: missed a boost, reset on next dispatch
+    long long virtual_time; // CFS: vruntime, stride: pass
+} checkpoint_entry_t;
+
+typedef struct {
+    int time;
+    int completed;
+    int next;               // Arrival-order cursor (FIFO: array index)
+    long long next_boost;   // MLFQ
+    int boost_epoch;        // MLFQ
+    long long virtual_clock; // CFS: min_vruntime, stride: global pass
+    uint64_t rng[4];        // Lottery: generator state
+    size_t events;          // Timeline length
+    int last_duration;      // Duration of the last event at that point
+    size_t first_entry;     // Ready jobs: entries[first_entry, +entry_count)
+    int entry_count;
+    metrics_acc_t acc;      // Accumulator at that point
+} checkpoint_t;
+
+typedef struct {
+    sim_policy_t policy;
+    int quantum;                            // RR
+    int mlfq_queues;                        // MLFQ
+    int mlfq_quantums[MLFQ_MAX_QUEUES];
+    int boost_interval;
+    cfs_config_t cfs;                       // CFS
+    uint64_t seed;                          // Lottery
+    int aging_interval;                     // Priority
+
+    checkpoint_t *checkpoints;
+    int count;
+    checkpoint_entry_t *entries;
+    size_t entry_count;
+    size_t entry_capacity;
+    size_t interval;        // Timeline events between snapshots
+    size_t next_capture;    // Timeline length that triggers the next one
+
+    int *order;             // Arrival order of the recorded run (NULL for FIFO)
+    int n;
+    int has_acc;            // The recorded run used an accumulator
+} sim_session_t;
+
+// The configs 'params' points to are copied
+void sim_session_init(sim_session_t *s, const sim_params_t *params);
+void sim_session_free(sim_session_t *s);
+
+// Full run from t=0 that records snapshots. Same contract as the
+// schedule_*_table engines.
+long sim_session_run(sim_session_t *s, proc_table_t *t, timeline_t *timeline, metrics_acc_t *acc);
+
+// Re-runs after the caller changed the arrival and/or burst of process 'idx'
+// in 't'. 't', 'timeline' and 'acc' must still hold the results of the
+// previous run. Falls back to a full run when no snapshot is usable.
+// '*resumed_at' (if not NULL) receives the simulation time resumed from.
+long sim_session_rerun(sim_session_t *s, proc_table_t *t, int idx, timeline_t *timeline,
+                       metrics_acc_t *acc, int *resumed_at);
+
+// --- Engine side (src/algorithms.c) ---
+
+// Runs the session's policy, from t=0 when 'from' is NULL
+long schedule_session(sim_session_t *s, proc_table_t *t, timeline_t *timeline,
+                      metrics_acc_t *acc, const checkpoint_t *from);
+
+// Starts a snapshot of the timeline and accumulator; the engine fills in its
+// own fields and ready jobs, then commits. Returns NULL if out of memory.
+checkpoint_t *checkpoint_begin(sim_session_t *s, const timeline_t *timeline, const metrics_acc_t *acc);
+int checkpoint_add(sim_session_t *s, checkpoint_t *cp, const checkpoint_entry_t *entry);
+void checkpoint_commit(sim_session_t *s);
+
+// Rewinds the timeline and accumulator to 'from' and drops later snapshots
+void checkpoint_restore(sim_session_t *s, const checkpoint_t *from, timeline_t *timeline,
+                        metrics_acc_t *acc);
+
+// Records the arrival order the run used. Returns 0, or -1 if out of memory.
+int checkpoint_keep_order(sim_session_t *s, const int *order, int n);
+
+static inline int checkpoint_due(const sim_session_t *s, const timeline_t *timeline) {
+    return s && timeline->count >= s->next_capture;
+}
+
+#endif // CHECKPOINT_H
@@ -0,0 +1,35 @@
+#ifndef FENWICK_H
+#define FENWICK_H
+
+#include "arena.h"
+
+// Fenwick (binary indexed) tree of non-negative weights over slots
+// [0, capacity). Updating a weight and finding the slot a cumulative weight
+// falls in are both O(log capacity), which makes weighted random selection
+// (lottery scheduling) logarithmic instead of a linear walk.
+
+typedef struct {
+    long long *tree;        // 1-based partial sums
+    int capacity;           // Always a power of two
+    arena_t *arena;         // Where the tree lives (NULL: the heap)
+} fenwick_t;
+
+// All weights start at zero. Returns 0, or -1 if out of memory.
+int fenwick_init(fenwick_t *f, int capacity, arena_t *arena);
+void fenwick_free(fenwick_t *f);
+
+// Makes room for at least 'capacity' slots, keeping the weights. Returns 0 or -1.
+int fenwick_reserve(fenwick_t *f, int capacity);
+
+// Adds 'delta' to the weight of 'slot'
+void fenwick_add(fenwick_t *f, int slot, long long delta);
+
+// Slot whose cumulative range holds 'target': the first slot where the
+// prefix sum exceeds it. Requires 0 <= target < fenwick_total(f).
+int fenwick_find(const fenwick_t *f, long long target);
+
+static inline long long fenwick_total(const fenwick_t *f) {
+    return f->tree[f->capacity];
+}
+
+#endif // FENWICK_H
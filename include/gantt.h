@@ -0,0 +1,63 @@
+#ifndef GANTT_H
+#define GANTT_H
+
+#include "scheduler.h"
+#include "trace.h"
+
+// Level-of-detail layout for the Gantt chart. Kept free of GTK/cairo so the
+// renderer only has to paint the bars it is handed.
+
+// Visible time window
+typedef struct {
+    double start;           // Time at the left edge
+    double span;            // Time units across the chart width
+} gantt_view_t;
+
+// Bar covering several processes inside one pixel column
+#define GANTT_MIXED -1
+
+typedef struct {
+    double x;               // Left edge in pixels from the chart origin
+    double width;           // Width in pixels
+    int pid;                // Process shown, or GANTT_MIXED
+} gantt_bar_t;
+
+typedef struct {
+    gantt_bar_t *bars;
+    size_t count;
+    size_t capacity;
+} gantt_layout_t;
+
+// View control. All of them keep the window inside [0, total_time].
+void gantt_view_fit(gantt_view_t *view, int total_time);
+void gantt_view_clamp(gantt_view_t *view, int total_time);
+void gantt_view_zoom(gantt_view_t *view, double factor, double anchor, int total_time);
+void gantt_view_pan(gantt_view_t *view, double delta, int total_time);
+
+// Index of the first event that ends after 'time' (count if none).
+// Events must be in time order and not overlap, as every scheduler emits them.
+size_t gantt_find(const timeline_t *timeline, double time);
+
+void gantt_layout_init(gantt_layout_t *layout);
+void gantt_layout_free(gantt_layout_t *layout);
+
+// Lays out the events visible in 'view' across 'width' pixels. Events
+// narrower than a pixel are merged into one bar per pixel column, so the
+// cost is O(width * log(events)) however many events are on screen.
+// Returns 0 on success, -1 if out of memory.
+int gantt_layout_build(gantt_layout_t *layout, const timeline_t *timeline,
+                       const gantt_view_t *view, double width);
+
+// The same layout read straight from a mapped trace file, decoding only the
+// events it visits: each lookup costs one index search plus at most one
+// stride of decoding, so the view never inflates the whole trace. The chart
+// has a single row, so this takes one-CPU traces only; a multi-core trace
+// lays out nothing.
+int gantt_layout_build_trace(gantt_layout_t *layout, const trace_t *trace,
+                             const gantt_view_t *view, double width);
+
+// Ruler spacing: the smallest 1/2/5 x 10^k whole-number step that keeps
+// ticks at least 'min_spacing' pixels apart
+int gantt_tick_step(const gantt_view_t *view, double width, double min_spacing);
+
+#endif // GANTT_H
@@ -0,0 +1,85 @@
+#ifndef INSTRUMENT_H
+#define INSTRUMENT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Scheduler instrumentation, off by default. Build with -DSCHED_INSTRUMENT
+// (make INSTRUMENT=1) for per-run event counters, or -DSCHED_INSTRUMENT_TIMERS
+// (make INSTRUMENT=2) to also time the pick-next and accounting phases with
+// the cycle counter. Without either flag every hook below expands to nothing.
+//
+// Counters are thread-local: each engine run resets them on entry, so after a
+// run returns, sched_counters holds that run's numbers on the calling thread.
+// The single-CPU core fills them all; the SMP engine resets them and records
+// only what the policies count themselves (demotions, queue steps).
+
+typedef struct {
+    uint64_t selections;        // pick_next calls
+    uint64_t context_switches;  // Timeline segments: a different job (or the end of idle) took the CPU
+    uint64_t preemptions;       // Runs cut short by an arrival
+    uint64_t requeues;          // Runs that ended with work left (slice, boost or preemption)
+    uint64_t boosts;            // Periodic boosts (MLFQ) or aging steps (priority)
+    uint64_t demotions;         // MLFQ level drops
+    uint64_t queue_steps;       // Heap and tree levels walked by the ready queues
+    uint64_t idle_ticks;        // Time the CPU sat idle before the last arrival
+    uint64_t ready_high_water;  // Most jobs ready at once
+    uint64_t pick_cycles;       // Timers only: time in pick_next
+    uint64_t account_cycles;    // Timers only: timeline, completion and requeue bookkeeping
+} sched_counters_t;
+
+typedef struct {
+    const char *name;
+    size_t offset;
+} sched_counter_field_t;
+
+#if defined(SCHED_INSTRUMENT_TIMERS) && !defined(SCHED_INSTRUMENT)
+#define SCHED_INSTRUMENT
+#endif
+
+#ifdef SCHED_INSTRUMENT
+
+#define SCHED_COUNTER_FIELDS 11
+extern const sched_counter_field_t sched_counter_fields[SCHED_COUNTER_FIELDS];
+extern _Thread_local sched_counters_t sched_counters;
+
+#define SCHED_RESET() ((void)(sched_counters = (sched_counters_t){0}))
+#define SCHED_COUNT(field) ((void)sched_counters.field++)
+#define SCHED_ADD(field, amount) ((void)(sched_counters.field += (uint64_t)(amount)))
+#define SCHED_MAX(field, value) \
+    ((void)((uint64_t)(value) > sched_counters.field ? (sched_counters.field = (uint64_t)(value)) : 0))
+
+#else
+
+#define SCHED_RESET() ((void)0)
+#define SCHED_COUNT(field) ((void)0)
+#define SCHED_ADD(field, amount) ((void)0)
+#define SCHED_MAX(field, value) ((void)0)
+
+#endif // SCHED_INSTRUMENT
+
+#ifdef SCHED_INSTRUMENT_TIMERS
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+static inline uint64_t sched_cycles(void) { return __rdtsc(); }
+#else
+#include <time.h>
+static inline uint64_t sched_cycles(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+#endif
+
+#define SCHED_TIMER_START(name) uint64_t name##_started = sched_cycles()
+#define SCHED_TIMER_STOP(name, field) SCHED_ADD(field, sched_cycles() - name##_started)
+
+#else
+
+#define SCHED_TIMER_START(name) ((void)0)
+#define SCHED_TIMER_STOP(name, field) ((void)0)
+
+#endif // SCHED_INSTRUMENT_TIMERS
+
+#endif // INSTRUMENT_H
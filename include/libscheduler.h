@@ -0,0 +1,138 @@
+#ifndef LIBSCHEDULER_H
+#define LIBSCHEDULER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Embedding API of libscheduler.a / libscheduler.so (make lib).
+// This header is self-contained: the ABI types are fixed-width and do not
+// expose the engines' internal structures, so they stay stable as the
+// engines change. Every call is re-entrant: there is no global state, and
+// separate threads may run batches at the same time.
+//
+// One sched_run_batch call runs every workload under every config, spread
+// over a pool of worker threads. Each worker keeps its process table,
+// timeline and policy arena for all the runs it takes, so after warm-up a
+// run costs the simulation and nothing else.
+
+#define SCHED_ABI_VERSION 1
+
+#if defined(__GNUC__)
+#define SCHED_API __attribute__((visibility("default")))
+#else
+#define SCHED_API
+#endif
+
+// Policies (same order as the simulator's own ids)
+enum {
+    SCHED_POLICY_FIFO,
+    SCHED_POLICY_SJF,
+    SCHED_POLICY_STCF,
+    SCHED_POLICY_RR,
+    SCHED_POLICY_MLFQ,
+    SCHED_POLICY_CFS,
+    SCHED_POLICY_LOTTERY,
+    SCHED_POLICY_STRIDE,
+    SCHED_POLICY_PRIORITY,
+    SCHED_POLICY_PRIORITY_PREEMPT,
+    SCHED_POLICY_COUNT
+};
+
+// Multi-core balancing modes
+enum {
+    SCHED_BALANCE_GLOBAL,   // One shared queue
+    SCHED_BALANCE_PUSH,     // Per-core queues, rebalanced every balance_interval ticks
+    SCHED_BALANCE_STEAL     // Per-core queues; an idle core steals half the busiest
+};
+
+// Status codes
+enum {
+    SCHED_OK = 0,
+    SCHED_EINVAL = -1,      // Bad argument, config or workload
+    SCHED_ENOMEM = -2       // Out of memory
+};
+
+#define SCHED_MLFQ_MAX_LEVELS 64
+#define SCHED_MAX_CPUS 4096
+
+typedef struct {
+    int32_t pid;
+    int32_t arrival_time;   // >= 0
+    int32_t burst_time;     // >= 0
+    int32_t priority;       // Lower runs first; a nice value for CFS, tickets for lottery/stride
+} sched_job_t;
+
+typedef struct {
+    const sched_job_t *jobs;    // In any order; read only
+    int32_t count;
+    int32_t reserved;       // Zero
+} sched_workload_t;
+
+// Start from sched_config_default; each policy reads only its own fields
+typedef struct {
+    int32_t policy;                 // SCHED_POLICY_*
+    int32_t quantum;                // RR, lottery, stride
+    int32_t mlfq_levels;            // 1..SCHED_MLFQ_MAX_LEVELS
+    int32_t mlfq_quantums[SCHED_MLFQ_MAX_LEVELS];
+    int32_t mlfq_boost_interval;    // 0 for no boost
+    int32_t cfs_latency;
+    int32_t cfs_granularity;
+    int32_t aging_interval;         // Priority policies, 0 for no aging
+    int32_t cpus;                   // 1..SCHED_MAX_CPUS
+    int32_t balance;                // SCHED_BALANCE_*, when cpus > 1
+    int32_t balance_interval;       // SCHED_BALANCE_PUSH
+    uint64_t seed;                  // Lottery
+    int32_t reserved[8];            // Zero
+} sched_config_t;
+
+typedef struct {
+    double p50;
+    double p95;
+    double p99;
+    double max;
+} sched_percentiles_t;
+
+typedef struct {
+    int32_t status;                 // SCHED_OK, or why this run failed
+    int32_t makespan;               // Latest completion
+    int64_t events;                 // Gantt chart events the run produced
+    int64_t migrations;             // cpus > 1: dispatches onto a different core
+    double avg_turnaround_time;
+    double avg_waiting_time;
+    double avg_response_time;
+    double cpu_utilization;         // Percent, over every core
+    double throughput;              // Jobs per tick
+    double fairness_index;          // Jain's index over turnaround times
+    sched_percentiles_t turnaround;
+    sched_percentiles_t waiting;
+    sched_percentiles_t response;
+} sched_result_t;
+
+// SCHED_ABI_VERSION of the library actually loaded
+SCHED_API int sched_abi_version(void);
+
+// Display name of a policy, or NULL if out of range
+SCHED_API const char *sched_policy_name(int32_t policy);
+
+// The command-line runner's defaults for 'policy' on one CPU: quantum 3,
+// MLFQ levels of 2/4/8 ticks boosted every 10, CFS 24/3, no aging, seed 1
+SCHED_API void sched_config_default(sched_config_t *config, int32_t policy);
+
+// Runs workloads[w] under configs[c] into results[w * config_count + c], for
+// every pair, on 'threads' worker threads (<= 0: one per online CPU). A
+// failed run only marks its own result. Returns SCHED_OK once every result
+// is filled in, SCHED_EINVAL for NULL arrays, or SCHED_ENOMEM if the
+// workers could not be set up (nothing has run).
+SCHED_API int sched_run_batch(const sched_workload_t *workloads, size_t workload_count,
+                              const sched_config_t *configs, size_t config_count,
+                              sched_result_t *results, int threads);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LIBSCHEDULER_H
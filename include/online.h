@@ -0,0 +1,93 @@
+#ifndef ONLINE_H
+#define ONLINE_H
+
+#include "policy.h"
+
+// Online scheduling: jobs are submitted one at a time as they arrive, and
+// the policy's dispatch decisions come out as soon as the arrivals seen so
+// far determine them. The loop is the batch core's (src/algorithms.c) taken
+// apart at the points where it would look into the future, over the same
+// policy ops and run queues. A stream submitted in arrival order therefore
+// gets exactly the schedule the batch engines give the whole workload.
+//
+// A decision at time T needs every arrival at T: submitting a job that
+// arrives later than T, or calling online_advance(T), says they are all in.
+// Arrivals at one time are enqueued together, as one batch.
+
+typedef enum {
+    ONLINE_DISPATCH,    // 'pid' takes the CPU at 'time' for up to 'duration'
+    ONLINE_PREEMPT,     // 'pid' lost the CPU at 'time' after 'duration'
+    ONLINE_COMPLETE     // 'pid' finished at 'time'
+} online_event_kind_t;
+
+typedef struct {
+    online_event_kind_t kind;
+    int time;
+    int pid;
+    int duration;
+} online_event_t;
+
+typedef void (*online_emit_fn)(void *ctx, const online_event_t *e);
+
+typedef struct {
+    sched_policy_t *p;
+    proc_table_t table;     // 'capacity' rows, filled in as jobs arrive
+    int capacity;
+    int admitted;           // Rows in use
+    int next;               // First row not yet on the run queue
+    int completed;
+    int ready;              // Jobs on the run queue
+    int now;
+    int known;              // Every arrival at or before this time is in
+    long long next_boost;
+    int running;            // Job on the CPU, or -1
+    int run_start;
+    long long run_end;      // Planned end of the current run
+    metrics_acc_t acc;
+    timeline_t *timeline;   // Optional record of the schedule
+    online_emit_fn emit;
+    void *emit_ctx;
+
+    // Decision latency: from the call that made a dispatch decidable to the
+    // moment it was emitted, in nanoseconds
+    uint64_t decisions;
+    histogram_t latency;
+    uint64_t call_started;
+    uint64_t engine_ns;     // Time spent inside submit/advance
+    uint64_t first_ns;      // First submission
+    uint64_t last_ns;       // Latest decision
+} online_t;
+
+typedef struct {
+    uint64_t jobs;
+    uint64_t completed;
+    uint64_t decisions;
+    double latency_p50;     // Nanoseconds
+    double latency_p99;
+    double latency_p999;
+    double latency_max;
+    double decisions_per_sec;       // Over the wall time of the stream
+    double engine_decisions_per_sec;    // Over the time spent scheduling
+    metrics_t metrics;      // Of the completed jobs
+} online_report_t;
+
+// Builds the policy 'params' names for up to 'capacity' jobs. 'emit' (may be
+// NULL) receives every decision; 'timeline' (may be NULL) records the
+// schedule as the batch engines would. Returns 0, or -1 if out of memory.
+int online_init(online_t *o, const sim_params_t *params, int capacity, online_emit_fn emit,
+                void *emit_ctx, timeline_t *timeline);
+void online_free(online_t *o);
+
+// Submits a job. Arrivals must not go back in time or land at or before a
+// time already advanced past. Returns 0, -1 if the job is out of order or
+// the capacity is used up, or -2 if the timeline could not grow.
+int online_submit(online_t *o, int pid, int arrival, int burst, int priority);
+
+// Declares every arrival at or before 'time' submitted and schedules as far
+// as that allows. online_advance(o, INT_MAX) ends the stream and runs every
+// submitted job to completion. Returns 0, or -2 if the timeline could not grow.
+int online_advance(online_t *o, int time);
+
+void online_report(const online_t *o, online_report_t *report);
+
+#endif // ONLINE_H
@@ -0,0 +1,103 @@
+#ifndef POLICY_H
+#define POLICY_H
+
+#include "scheduler.h"
+#include "checkpoint.h"
+#include "arena.h"
+
+// Pluggable scheduling policies. The event-driven cores (the single-CPU loop
+// in src/algorithms.c and the multi-core one in src/smp.c) own the clock, the
+// arrival cursor, the timeline and completion accounting. A policy only
+// decides the order of ready jobs and how long each may run. It keeps one or
+// more run queues, numbered from 0 (the SMP engine uses one per core).
+//
+// A new policy fills in a sched_policy_ops_t and embeds sched_policy_t as the
+// first member of its own state.
+
+typedef struct sched_policy sched_policy_t;
+
+typedef struct {
+    const char *name;
+
+    // Serve jobs in table order, whatever their arrival times (FIFO)
+    int admit_by_index;
+
+    // Frees everything the policy allocated, including itself
+    void (*destroy)(sched_policy_t *p);
+
+    // Prepares a job that has not arrived yet (optional)
+    void (*reset)(sched_policy_t *p, int idx);
+
+    // Job 'idx' becomes ready on queue 'q', keeping its policy state
+    void (*enqueue)(sched_policy_t *p, int q, int idx);
+
+    // Removes and returns the job queue 'q' runs next. Only called when the
+    // queue is not empty.
+    int (*pick_next)(sched_policy_t *p, int q);
+
+    // Longest run 'idx' may have before on_tick_expiry, INT_MAX for no limit
+    int (*slice)(const sched_policy_t *p, int idx);
+
+    // 'idx' ran for 'ran' ticks and still has work left: its slice ran out or
+    // it was cut short (by an arrival, a boost or a preemption). Must put it
+    // back on queue 'q'.
+    void (*on_tick_expiry)(sched_policy_t *p, int q, int idx, int ran);
+
+    // Moves 'count' jobs (at most the queue's size) from queue 'from' to
+    // queue 'to' for SMP balancing. They come off the back of 'from': the
+    // jobs it would run last, or for heaps and lottery whichever are cheapest
+    // to detach, which is never the next job while others are left. Unlike
+    // pick_next it leaves the virtual clock of 'from' alone. Optional: the
+    // SMP engine falls back to pick_next and enqueue.
+    void (*migrate)(sched_policy_t *p, int from, int to, int count);
+
+    // Periodic priority boost, every boost_interval ticks (optional)
+    void (*on_boost)(sched_policy_t *p);
+
+    // Preemptive policies only (NULL otherwise). Non-zero if the best job on
+    // queue 'q' should displace 'running', which has 'left' ticks to go.
+    int (*preempts)(const sched_policy_t *p, int q, int running, int left);
+
+    // Preemptive policies only. How weak the claim of 'running' to its CPU
+    // is; with a shared queue the weakest running job is preempted first.
+    long long (*rank)(const sched_policy_t *p, int running, int left);
+
+    // Checkpoints: records the ready jobs of queue 'q' (returns non-zero if
+    // the snapshot had to be dropped), and rebuilds them from a snapshot
+    int (*capture)(const sched_policy_t *p, int q, sim_session_t *s, checkpoint_t *cp);
+    void (*restore)(sched_policy_t *p, int q, const sim_session_t *s, const checkpoint_t *cp);
+} sched_policy_ops_t;
+
+struct sched_policy {
+    const sched_policy_ops_t *ops;
+    proc_table_t *t;
+    int nr_queues;
+    long long boost_interval;   // <= 0 when the policy never boosts
+    int failed;                 // Set when a queue could not grow
+    arena_t *arena;             // Where the policy's state lives (NULL: the heap)
+};
+
+// Builds the built-in policy 'params' names over 't' with 'nr_queues' run
+// queues, allocating from 'arena' (NULL for the heap). Returns NULL if out of
+// memory.
+sched_policy_t *sched_policy_create(const sim_params_t *params, proc_table_t *t, int nr_queues,
+                                    arena_t *arena);
+
+static inline void sched_policy_destroy(sched_policy_t *p) {
+    if (p) p->ops->destroy(p);
+}
+
+// Runs any policy built over 't' (with at least one queue) on one CPU.
+// Same contract as the schedule_*_table engines.
+long schedule_policy_table(proc_table_t *t, sched_policy_t *p, timeline_t *timeline,
+                           metrics_acc_t *acc);
+
+// Runs the built-in policy 'params' names with all of its per-run state (run
+// queues, heaps, bitmaps, admission order) carved out of 'arena', which is
+// reset first. Callers running many simulations back to back keep one arena
+// per thread; once it has grown to fit, a run makes no heap allocations
+// beyond the timeline's own growth.
+long schedule_params_table(const sim_params_t *params, proc_table_t *t, arena_t *arena,
+                           timeline_t *timeline, metrics_acc_t *acc);
+
+#endif // POLICY_H
@@ -0,0 +1,38 @@
+#ifndef PQUEUE_H
+#define PQUEUE_H
+
+#include "arena.h"
+
+// Binary min-heap of process indices.
+// Ordering is supplied by the caller, so the same heap serves every policy
+// that needs "pick the best ready job" (STCF by remaining time, SJF by burst...).
+
+// Returns non-zero when item 'a' must be dispatched before item 'b'
+typedef int (*pqueue_less_fn)(const void *ctx, int a, int b);
+
+typedef struct {
+    int *items;             // Heap-ordered process indices
+    int size;               // Number of queued items
+    int capacity;           // Allocated slots
+    pqueue_less_fn less;    // Ordering predicate
+    const void *ctx;        // Passed through to 'less' (usually the process array)
+    arena_t *arena;         // Where the items live (NULL: the heap)
+} pqueue_t;
+
+// Returns 0 on success, -1 if the storage could not be allocated
+int pqueue_init(pqueue_t *pq, int capacity, pqueue_less_fn less, const void *ctx, arena_t *arena);
+void pqueue_free(pqueue_t *pq);
+
+// Grows the storage to hold at least 'capacity' items. Returns 0 or -1.
+int pqueue_reserve(pqueue_t *pq, int capacity);
+
+void pqueue_push(pqueue_t *pq, int item);
+int pqueue_pop(pqueue_t *pq);
+
+static inline int pqueue_empty(const pqueue_t *pq) { return pq->size == 0; }
+static inline int pqueue_peek(const pqueue_t *pq) { return pq->items[0]; }
+
+// Removes the last item in heap order. It is a leaf, so the heap stays valid.
+static inline int pqueue_pop_last(pqueue_t *pq) { return pq->items[--pq->size]; }
+
+#endif // PQUEUE_H
@@ -0,0 +1,37 @@
+#ifndef PROCESS_MODEL_H
+#define PROCESS_MODEL_H
+
+#include <gtk/gtk.h>
+#include "scheduler.h"
+
+// GtkTreeModel that reads straight from a process_t array, so the process
+// table has no second copy of the workload. Rows are produced on demand;
+// with a fixed-height GtkTreeView only the visible ones are ever read.
+
+enum {
+    PROCESS_COLUMN_PID,
+    PROCESS_COLUMN_ARRIVAL,
+    PROCESS_COLUMN_BURST,
+    PROCESS_COLUMN_PRIORITY,
+    PROCESS_MODEL_N_COLUMNS
+};
+
+#define PROCESS_TYPE_MODEL (process_model_get_type())
+G_DECLARE_FINAL_TYPE(ProcessModel, process_model, PROCESS, MODEL, GObject)
+
+ProcessModel *process_model_new(void);
+
+// The backing array; valid until the next append or replace
+process_t *process_model_rows(ProcessModel *model, int *count);
+
+// Appends one row. Returns 0 on success, -1 if out of memory.
+int process_model_append(ProcessModel *model, const process_t *process);
+
+// Takes ownership of a malloc'd array (e.g. from workload_load) and frees
+// the old one. Views should be detached first: no per-row signals are sent.
+void process_model_replace(ProcessModel *model, process_t *rows, int count);
+
+// Writes one cell back to the array
+void process_model_set(ProcessModel *model, int row, int column, int value);
+
+#endif // PROCESS_MODEL_H
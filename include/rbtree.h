@@ -0,0 +1,51 @@
+#ifndef RBTREE_H
+#define RBTREE_H
+
+#include "arena.h"
+
+// Red-black tree of process indices, intrusive like the MLFQ lists: the
+// links live in per-process arrays (rb_nodes_t), so several trees can share
+// one node pool as long as each process sits in at most one of them.
+// Ordering is supplied by the caller, as with pqueue_t.
+//
+// Insert and erase are O(log n); the leftmost node is cached, so peeking at
+// the best job is O(1).
+
+// Returns non-zero when item 'a' sorts before item 'b'. Must be a strict
+// total order (break ties on the index).
+typedef int (*rb_less_fn)(const void *ctx, int a, int b);
+
+typedef struct {
+    int *left;
+    int *right;
+    int *parent;
+    unsigned char *red;
+    int nil;                // Sentinel node (index 'capacity'), always black
+    rb_less_fn less;
+    const void *ctx;
+    arena_t *arena;         // Where the links live (NULL: the heap)
+} rb_nodes_t;
+
+typedef struct {
+    int root;
+    int first;              // Leftmost node
+    int size;
+} rbtree_t;
+
+// Node storage for indices [0, capacity). Returns 0, or -1 if out of memory.
+int rb_nodes_init(rb_nodes_t *nodes, int capacity, rb_less_fn less, const void *ctx, arena_t *arena);
+void rb_nodes_free(rb_nodes_t *nodes);
+
+void rbtree_init(const rb_nodes_t *nodes, rbtree_t *tree);
+void rbtree_insert(rb_nodes_t *nodes, rbtree_t *tree, int item);
+void rbtree_erase(rb_nodes_t *nodes, rbtree_t *tree, int item);
+
+// In-order successor of 'item', or -1
+int rbtree_next(const rb_nodes_t *nodes, int item);
+
+// Smallest item, or -1 when empty
+static inline int rbtree_first(const rbtree_t *tree) {
+    return tree->size ? tree->first : -1;
+}
+
+#endif // RBTREE_H
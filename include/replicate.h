@@ -0,0 +1,50 @@
+#ifndef REPLICATE_H
+#define REPLICATE_H
+
+#include <stddef.h>
+#include "scheduler.h"
+#include "workload_gen.h"
+
+// Monte Carlo replication: draws K seeded workloads from one distribution
+// spec, runs every built-in policy on each, and reports the mean and 95%
+// confidence interval of every metrics_t field across the replications.
+//
+// Replications run on the work-stealing thread pool. Replication r takes its
+// workload and lottery seeds from a stream derived only from the master seed
+// and r, and the per-replication metrics are reduced in replication order,
+// so the results are bit-identical whatever the thread count.
+
+typedef struct {
+    workload_spec_t workload;   // Distribution; its seed is set per replication
+    int replications;           // K
+    uint64_t seed;              // Master seed
+    sim_params_t params;        // Policy settings; policy and seed are set per run
+    int threads;                // Worker threads, <= 0 for one per CPU
+} replicate_spec_t;
+
+typedef struct {
+    sim_policy_t policy;
+    const char *name;
+    int replications;           // Runs that completed (the others ran out of memory)
+    metrics_t mean;
+    metrics_t half_width;       // 95% CI is mean +- half_width (0 below two runs)
+} replicate_result_t;
+
+// Every metrics_t field (all doubles), for reports that walk them
+typedef struct {
+    const char *name;
+    size_t offset;
+} metrics_field_t;
+
+#define METRICS_FIELD_COUNT 18
+extern const metrics_field_t metrics_fields[METRICS_FIELD_COUNT];
+
+// 1000 jobs from the default workload spec, 30 replications, seed 1,
+// quantum 3, MLFQ 2/4/8 with boost 10, CFS defaults, no aging
+void replicate_default_spec(replicate_spec_t *spec);
+
+// Fills results[0..SIM_POLICY_COUNT) in sim_policy_t order. Returns 0, or
+// -1 if out of memory before anything ran.
+int replicate_run(const replicate_spec_t *spec, replicate_result_t *results);
+
+#endif // REPLICATE_H
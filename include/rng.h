@@ -0,0 +1,64 @@
+#ifndef RNG_H
+#define RNG_H
+
+#include <stdint.h>
+#include <math.h>
+
+// Small, fast, seedable PRNG (xoshiro256**, seeded through splitmix64).
+// Each generator is a plain value, so threads can own independent streams
+// and results depend only on the seed.
+typedef struct {
+    uint64_t s[4];
+} rng_t;
+
+static inline uint64_t rng_splitmix64(uint64_t *x) {
+    uint64_t z = (*x += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+static inline void rng_seed(rng_t *rng, uint64_t seed) {
+    for (int i = 0; i < 4; i++) rng->s[i] = rng_splitmix64(&seed);
+}
+
+static inline uint64_t rng_rotl(uint64_t x, int k) {
+    return (x << k) | (x >> (64 - k));
+}
+
+static inline uint64_t rng_next(rng_t *rng) {
+    uint64_t *s = rng->s;
+    uint64_t result = rng_rotl(s[1] * 5, 7) * 9;
+    uint64_t t = s[1] << 17;
+
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = rng_rotl(s[3], 45);
+    return result;
+}
+
+// Uniform double in (0, 1]: never 0, so it is safe to take its log
+static inline double rng_uniform(rng_t *rng) {
+    return ((rng_next(rng) >> 11) + 1) * (1.0 / 9007199254740992.0);
+}
+
+// Uniform integer in [0, bound)
+static inline uint64_t rng_below(rng_t *rng, uint64_t bound) {
+    return bound ? rng_next(rng) % bound : 0;
+}
+
+// Exponential with the given mean
+static inline double rng_exponential(rng_t *rng, double mean) {
+    return -mean * log(rng_uniform(rng));
+}
+
+// Pareto (type I) with shape alpha > 1 and the given mean
+static inline double rng_pareto(rng_t *rng, double mean, double alpha) {
+    double xm = mean * (alpha - 1.0) / alpha;
+    return xm / pow(rng_uniform(rng), 1.0 / alpha);
+}
+
+#endif // RNG_H
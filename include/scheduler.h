@@ -3,8 +3,8 @@
 
 #include <stdlib.h>
 #include <stdio.h>
-
-#define MAX_PROCESSES 100 // Maximum number of processes
+#include <stdint.h>
+#include "arena.h"
 
 // Represents a single process in the simulator
 typedef struct {
@@ -20,14 +20,66 @@ typedef struct {
     int response_time;      // start - arrival
 } process_t;
 
+// Structure-of-arrays process storage used by the scheduling engines.
+// The hot columns are the only ones the ready queues and selection loops
+// touch; the cold columns are written once, when a process starts or ends.
+// All columns live in one allocation.
+typedef struct {
+    int n;
+    // Hot: scheduling inputs and state
+    int *arrival_time;
+    int *burst_time;
+    int *remaining_time;
+    int *priority;
+    // Cold: identity and results
+    int *pid;
+    int *start_time;
+    int *completion_time;
+    int *turnaround_time;
+    int *waiting_time;
+    int *response_time;
+    void *block;            // Backing storage for every column
+} proc_table_t;
+
 // Represents a slice of execution on the Gantt chart
 typedef struct {
     int time;               // Time slice start
     int pid;                // Process running
     int duration;           // How long it ran
+    int cpu;                // Core it ran on (0 for the single-CPU schedulers)
 } timeline_event_t;
 
+struct timeline;
+
+// Called from timeline_append each time TIMELINE_CHUNK events have been
+// written since the last call. events[published, count - 1) are final (the
+// last event may still be extended). Returning non-zero makes the append
+// fail, which stops the scheduler the same way running out of memory does.
+typedef int (*timeline_observer_fn)(void *ctx, const struct timeline *timeline);
+
+#define TIMELINE_CHUNK 4096
+
+// Growable Gantt chart buffer, owned by the caller.
+// Schedulers clear it and append to it; the storage is kept between runs.
+typedef struct timeline {
+    timeline_event_t *events;
+    size_t count;           // Events written
+    size_t capacity;        // Events allocated
+    size_t published;       // Events already handed to the observer
+    timeline_observer_fn observer;  // Optional, see above
+    void *observer_ctx;
+} timeline_t;
+
 // --- Part 3: Metrics ---
+
+// Tail of one per-process time distribution
+typedef struct {
+    double p50;
+    double p95;
+    double p99;
+    double max;
+} percentiles_t;
+
 typedef struct {
     double avg_turnaround_time;
     double avg_waiting_time;
@@ -35,32 +87,202 @@ typedef struct {
     double cpu_utilization;
     double throughput;
     double fairness_index;      // Jain's fairness index
+    percentiles_t turnaround;
+    percentiles_t waiting;
+    percentiles_t response;
 } metrics_t;
 
+// Fixed-size log-bucketed histogram of non-negative times.
+// Values below 64 get their own bucket; above that each power of two is split
+// into 32 buckets, so percentiles are within ~3% of the true value.
+#define HIST_EXACT 64
+#define HIST_SUB_BUCKETS 32
+#define HIST_BUCKETS (HIST_EXACT + 26 * HIST_SUB_BUCKETS) // Covers every int
+
+typedef struct {
+    uint64_t counts[HIST_BUCKETS];
+    int max;
+} histogram_t;
+
+// Adds a non-negative value (zero it first with memset)
+void histogram_add(histogram_t *h, int value);
+
+// Nearest-rank percentile 'q' (0..1) of the 'total' values added, reported as
+// the middle of its bucket
+double histogram_percentile(const histogram_t *h, uint64_t total, double q);
+
+// Streaming metrics accumulator. Schedulers feed it each process as it
+// completes, so the final metrics need no second pass over the array.
+// Integer sums are exact in 64 bits; the sum of squares (for fairness) uses
+// compensated summation.
+typedef struct {
+    uint64_t count;
+    int64_t total_turnaround;
+    int64_t total_waiting;
+    int64_t total_response;
+    int64_t total_burst;
+    double sum_sq_turnaround;
+    double sum_sq_compensation;
+    int max_completion;
+    histogram_t turnaround;
+    histogram_t waiting;
+    histogram_t response;
+} metrics_acc_t;
+
 // --- Function Prototypes ---
 
+// Process table management. Each returns 0 on success, -1 if out of memory.
+int proc_table_init(proc_table_t *t, int n);
+void proc_table_free(proc_table_t *t);
+int proc_table_from_array(proc_table_t *t, const process_t *processes, int n);
+void proc_table_to_array(const proc_table_t *t, process_t *processes);
+
+// Fills every column of an allocated table's t->n rows from 'processes'
+void proc_table_load(proc_table_t *t, const process_t *processes);
+
+// Copies pid/arrival/burst/priority from 'src' into an equally sized table
+// and clears its simulation state, ready for another run
+void proc_table_copy_inputs(proc_table_t *dst, const proc_table_t *src);
+
+// Process indices ordered by (arrival_time, index), the order every engine
+// admits processes in. Returns an array from 'arena' (NULL: malloc'd), or NULL
+// if out of memory.
+int *proc_table_arrival_order(const proc_table_t *t, arena_t *arena);
+
+// Records the completion of process 'idx' (and the derived times) and feeds
+// it to the streaming accumulator, if any
+void proc_table_finish(proc_table_t *t, int idx, int completion_time, metrics_acc_t *acc);
+
+// Timeline buffer management
+void timeline_init(timeline_t *timeline);
+void timeline_free(timeline_t *timeline);
+void timeline_clear(timeline_t *timeline);
+int timeline_reserve(timeline_t *timeline, size_t capacity);
+
+// Appends a run segment, extending the last event when the same process just
+// keeps the CPU. Returns 0 on success, -1 if the buffer could not grow.
+int timeline_append(timeline_t *timeline, int time, int pid, int duration);
+int timeline_append_cpu(timeline_t *timeline, int cpu, int time, int pid, int duration);
+
+// Installs (or with NULL removes) the observer. It is kept across clears.
+void timeline_observe(timeline_t *timeline, timeline_observer_fn observer, void *ctx);
+
+// Every scheduler returns the number of timeline events it wrote,
+// or -1 if it ran out of memory. If 'acc' is not NULL, each process is added
+// to it as it completes (the accumulator is not reset first).
+//
+// The *_table engines run directly on a proc_table_t; the process_t versions
+// convert to a table and back around them.
+
+// Policy identifiers shared by sessions, the SMP engine and front ends
+typedef enum {
+    SIM_FIFO,
+    SIM_SJF,
+    SIM_STCF,
+    SIM_RR,
+    SIM_MLFQ,
+    SIM_CFS,
+    SIM_LOTTERY,
+    SIM_STRIDE,
+    SIM_PRIORITY,
+    SIM_PRIORITY_PREEMPT
+} sim_policy_t;
+
+#define SIM_POLICY_COUNT (SIM_PRIORITY_PREEMPT + 1)
+
 // Algorithm 1: FIFO
-void schedule_fifo(process_t *processes, int n, timeline_event_t *timeline);
+long schedule_fifo(process_t *processes, int n, timeline_t *timeline, metrics_acc_t *acc);
+long schedule_fifo_table(proc_table_t *t, timeline_t *timeline, metrics_acc_t *acc);
 
 // Algorithm 2: SJF
-void schedule_sjf(process_t *processes, int n, timeline_event_t *timeline);
+long schedule_sjf(process_t *processes, int n, timeline_t *timeline, metrics_acc_t *acc);
+long schedule_sjf_table(proc_table_t *t, timeline_t *timeline, metrics_acc_t *acc);
 
 // Algorithm 3: STCF
-void schedule_stcf(process_t *processes, int n, timeline_event_t *timeline);
+long schedule_stcf(process_t *processes, int n, timeline_t *timeline, metrics_acc_t *acc);
+long schedule_stcf_table(proc_table_t *t, timeline_t *timeline, metrics_acc_t *acc);
 
 // Algorithm 4: Round Robin
-void schedule_rr(process_t *processes, int n, int quantum, timeline_event_t *timeline);
+long schedule_rr(process_t *processes, int n, int quantum, timeline_t *timeline, metrics_acc_t *acc);
+long schedule_rr_table(proc_table_t *t, int quantum, timeline_t *timeline, metrics_acc_t *acc);
 
 // Algorithm 5: MLFQ
+#define MLFQ_MAX_QUEUES 64 // Levels are tracked in a 64-bit bitmap
+
 typedef struct {
     int num_queues;
     int *quantums;      // Array of quantums for each queue
     int boost_interval; // Priority boost interval
 } mlfq_config_t;
 
-void schedule_mlfq(process_t *processes, int n, mlfq_config_t *config, timeline_event_t *timeline);
+long schedule_mlfq(process_t *processes, int n, mlfq_config_t *config, timeline_t *timeline,
+                   metrics_acc_t *acc);
+long schedule_mlfq_table(proc_table_t *t, mlfq_config_t *config, timeline_t *timeline,
+                         metrics_acc_t *acc);
+
+// Algorithm 6: CFS (Completely Fair Scheduler)
+// Priority is read as a Linux nice value (clamped to -20..19) and mapped to
+// the kernel's weight table. Every runnable job gets a slice of
+// max(sched_latency, runnable * min_granularity) in proportion to its weight.
+typedef struct {
+    int sched_latency;      // Period in which every runnable job should run once
+    int min_granularity;    // Shortest slice, and the wakeup preemption margin
+} cfs_config_t;
+
+void cfs_default_config(cfs_config_t *config);
+
+long schedule_cfs(process_t *processes, int n, const cfs_config_t *config, timeline_t *timeline,
+                  metrics_acc_t *acc);
+long schedule_cfs_table(proc_table_t *t, const cfs_config_t *config, timeline_t *timeline,
+                        metrics_acc_t *acc);
+
+// Algorithms 7 and 8: lottery and stride scheduling
+// Proportional share with priority as the ticket count (at least 1). Every
+// 'quantum' ticks lottery draws a winning ticket from the seeded generator;
+// stride runs the job with the lowest pass, which advances by 1/tickets
+// per tick run. Identical seeds give identical runs.
+long schedule_lottery(process_t *processes, int n, int quantum, uint64_t seed, timeline_t *timeline,
+                      metrics_acc_t *acc);
+long schedule_lottery_table(proc_table_t *t, int quantum, uint64_t seed, timeline_t *timeline,
+                            metrics_acc_t *acc);
+long schedule_stride(process_t *processes, int n, int quantum, timeline_t *timeline, metrics_acc_t *acc);
+long schedule_stride_table(proc_table_t *t, int quantum, timeline_t *timeline, metrics_acc_t *acc);
+
+// Algorithms 9 and 10: static priority, non-preemptive and preemptive
+// Priority is the level (clamped to 0..PRIORITY_LEVELS-1, lower runs first);
+// each level is served FIFO. With aging_interval > 0, every aging_interval
+// ticks each waiting job moves up one level, so low priorities cannot starve.
+#define PRIORITY_LEVELS 64 // One bit per level, like MLFQ
+
+long schedule_priority(process_t *processes, int n, int preemptive, int aging_interval,
+                       timeline_t *timeline, metrics_acc_t *acc);
+long schedule_priority_table(proc_table_t *t, int preemptive, int aging_interval, timeline_t *timeline,
+                             metrics_acc_t *acc);
+
+// Everything needed to build a policy by id; each policy reads only its own
+// fields, so the others may be left zero / NULL
+typedef struct {
+    sim_policy_t policy;
+    int quantum;                // SIM_RR, SIM_LOTTERY, SIM_STRIDE
+    const mlfq_config_t *mlfq;  // SIM_MLFQ
+    const cfs_config_t *cfs;    // SIM_CFS, NULL for the defaults
+    uint64_t seed;              // SIM_LOTTERY
+    int aging_interval;         // SIM_PRIORITY*, 0 for no aging
+} sim_params_t;
 
 // Metrics Calculation
+void metrics_acc_init(metrics_acc_t *acc);
+void metrics_acc_add(metrics_acc_t *acc, const process_t *p);
+void metrics_acc_add_times(metrics_acc_t *acc, int burst, int completion, int turnaround,
+                           int waiting, int response);
+void metrics_acc_merge(metrics_acc_t *into, const metrics_acc_t *from);
+
+// Final metrics; total_time <= 0 means "latest completion seen"
+void metrics_acc_finish(const metrics_acc_t *acc, int total_time, metrics_t *metrics);
+
+// Batch versions for an already-scheduled array or table. The table version
+// computes the sums with SIMD column reductions.
 void calculate_metrics(process_t *processes, int n, int total_time, metrics_t *metrics);
+void calculate_metrics_table(const proc_table_t *t, int total_time, metrics_t *metrics);
 
 #endif // SCHEDULER_H
\ No newline at end of file
@@ -0,0 +1,26 @@
+#ifndef SCRATCH_H
+#define SCRATCH_H
+
+#include "scheduler.h"
+
+// Per-worker scratch space for drivers that run many simulations back to
+// back on the thread pool (sweeps, replication, the embedding library).
+// Each worker owns one and nothing in it is shared. The buffers only grow,
+// so once they fit the largest run a worker has seen, runs stop allocating.
+typedef struct {
+    proc_table_t table;     // Table each run works on
+    int capacity;           // Rows allocated in 'table'
+    timeline_t timeline;
+    arena_t arena;          // Policy state, recycled across runs
+    metrics_acc_t acc;
+    char pad[64];           // Keeps neighbouring workers off the same cache line
+} worker_scratch_t;
+
+void worker_scratch_init(worker_scratch_t *s);
+void worker_scratch_free(worker_scratch_t *s);
+
+// Gives 'table' n rows, reallocating only if it has room for fewer. The
+// contents are left for the caller to fill. Returns 0, or -1 if out of memory.
+int worker_scratch_table(worker_scratch_t *s, int n);
+
+#endif // SCRATCH_H
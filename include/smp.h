@@ -0,0 +1,47 @@
+#ifndef SMP_H
+#define SMP_H
+
+#include "scheduler.h"
+
+// Multi-core (SMP) simulation. Every policy runs with one run queue per
+// simulated core, and a balancing mode decides how work moves between them.
+// Timeline events carry the core id. Each core's events are in time order,
+// but cores interleave: an event is written when its core switches away.
+
+#define SMP_MAX_CPUS 4096
+
+typedef enum {
+    SMP_GLOBAL,     // One shared queue; any idle core takes the next job
+    SMP_PUSH,       // Per-core queues, rebalanced every balance_interval ticks
+    SMP_STEAL       // Per-core queues; an idle core steals half the busiest queue
+} smp_balance_t;
+
+typedef struct {
+    int cpus;
+    smp_balance_t balance;
+    int balance_interval;   // SMP_PUSH: ticks between push passes
+} smp_config_t;
+
+typedef struct {
+    int cpus;
+    long migrations;        // Dispatches on a different core than the job last ran on
+    int makespan;           // Latest completion
+    double utilization;     // Busy time over cpus * makespan, in percent
+    double *core_utilization;   // Optional, 'cpus' entries filled in when not NULL
+} smp_stats_t;
+
+// Fills 'config' for 'cpus' cores with work stealing
+void smp_default_config(smp_config_t *config, int cpus);
+
+// Parses "global", "push" or "steal". Returns 0 on success, -1 otherwise.
+int smp_parse_balance(const char *text, smp_balance_t *balance);
+const char *smp_balance_name(smp_balance_t balance);
+
+// Runs the policy 'params' names on config->cpus cores. 'stats' may be NULL.
+// Same contract as the single-CPU *_table engines; with one core the
+// results match them. As in schedule_params_table, the per-run state comes
+// from 'arena', which is reset first (NULL: the heap).
+long schedule_smp_table(proc_table_t *t, const sim_params_t *params, const smp_config_t *config,
+                        arena_t *arena, timeline_t *timeline, metrics_acc_t *acc, smp_stats_t *stats);
+
+#endif // SMP_H
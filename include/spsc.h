@@ -0,0 +1,28 @@
+#ifndef SPSC_H
+#define SPSC_H
+
+#include <stdatomic.h>
+#include <stddef.h>
+
+// Bounded lock-free queue for exactly one producer thread and one consumer
+// thread. Items are opaque pointers; ownership moves with them.
+
+typedef struct {
+    void **slots;
+    size_t mask;                    // Capacity - 1 (capacity is a power of two)
+    _Alignas(64) atomic_size_t head;    // Next slot to read, written by the consumer
+    _Alignas(64) atomic_size_t tail;    // Next slot to write, written by the producer
+} spsc_queue_t;
+
+// Capacity is rounded up to a power of two.
+// Returns 0 on success, -1 if the storage could not be allocated.
+int spsc_init(spsc_queue_t *q, size_t capacity);
+void spsc_free(spsc_queue_t *q);
+
+// Producer side: returns 0, or -1 if the queue is full
+int spsc_push(spsc_queue_t *q, void *item);
+
+// Consumer side: returns the oldest item, or NULL if the queue is empty
+void *spsc_pop(spsc_queue_t *q);
+
+#endif // SPSC_H
@@ -0,0 +1,54 @@
+#ifndef SWEEP_H
+#define SWEEP_H
+
+#include "scheduler.h"
+
+// Parameter sweep over Round Robin quanta and MLFQ configurations.
+// Every grid point is simulated on a work-stealing thread pool (each worker
+// owns one copy of the process array and one timeline), then the Pareto
+// front of average turnaround vs. average response time is marked.
+
+// Inclusive integer range; step <= 0 is treated as 1. An empty range
+// (min > max) leaves that dimension, or the whole policy, out of the grid.
+typedef struct {
+    int min;
+    int max;
+    int step;
+} sweep_range_t;
+
+typedef struct {
+    sweep_range_t rr_quantum;       // Round Robin time quantum
+    sweep_range_t mlfq_levels;      // Number of MLFQ queues
+    sweep_range_t mlfq_quantum;     // Quantum of the top MLFQ level
+    sweep_range_t mlfq_factor;      // Each lower level's quantum is this many times the one above
+    sweep_range_t mlfq_boost;       // Priority boost interval (0 disables boosting)
+    int threads;                    // Worker threads, <= 0 for one per CPU
+} sweep_spec_t;
+
+typedef enum {
+    SWEEP_RR,
+    SWEEP_MLFQ
+} sweep_policy_t;
+
+typedef struct {
+    sweep_policy_t policy;
+    int quantum;            // RR quantum, or top-level MLFQ quantum
+    int levels;             // MLFQ only
+    int factor;             // MLFQ only
+    int boost_interval;     // MLFQ only
+    metrics_t metrics;
+    long events;            // Timeline events, -1 if the run failed
+    int pareto;             // Non-zero if on the turnaround/response Pareto front
+} sweep_result_t;
+
+// Fills 'spec' with the default grid
+void sweep_default_spec(sweep_spec_t *spec);
+
+// Parses "min:max[:step]" or a single value. Returns 0 on success, -1 on error.
+int sweep_parse_range(const char *text, sweep_range_t *range);
+
+// Runs the whole grid. On success stores a malloc'd result array in *results
+// (caller frees) and returns its length; returns -1 if out of memory.
+long sweep_run(const process_t *workload, int n, const sweep_spec_t *spec, sweep_result_t **results);
+
+#endif // SWEEP_H
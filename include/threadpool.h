@@ -0,0 +1,22 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <stddef.h>
+
+// Runs tasks 0..tasks-1 on a set of worker threads with work stealing.
+// Each worker starts with a contiguous slice of the task range and takes
+// tasks from its front; a worker that runs dry steals the back half of the
+// busiest remaining slice. 'worker' (0..workers-1) identifies the calling
+// thread so tasks can use per-worker scratch space without locking.
+typedef void (*pool_task_fn)(void *ctx, int worker, size_t task);
+
+// Number of online CPUs (at least 1)
+int pool_default_workers(void);
+
+// Blocks until every task has run. workers <= 0 uses pool_default_workers().
+// The calling thread works too, so every task runs even if no extra thread
+// can be started. Returns the number of threads that took part, or -1 if out
+// of memory (in which case nothing has run).
+int pool_run(int workers, size_t tasks, pool_task_fn fn, void *ctx);
+
+#endif // THREADPOOL_H
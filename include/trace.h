@@ -0,0 +1,136 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include "scheduler.h"
+
+// --- Compact timeline format ---
+// A timeline_event_t takes 16 bytes. A trace stores each event as four
+// LEB128 varints, usually 4-6 bytes in all:
+//   zigzag(time - end of the previous event), zigzag(pid - previous pid),
+//   duration, cpu
+// Back-to-back slices of the same process on the same CPU are merged first.
+// Every 'stride' events the deltas restart from zero and the event's byte
+// offset goes into a sparse index, so a reader can start decoding at any
+// multiple of the stride without touching what comes before.
+//
+// Events are in the order the engine finished them. One CPU finishes them
+// in start order, but a multi-core run writes a core's slice when the core
+// switches away, so their starts can go backwards. Each index entry
+// therefore keeps the earliest start from that entry to the end of the
+// trace, which tells a reader when no later event can reach into a window.
+//
+// File layout (host byte order): the 56-byte header, the encoded events,
+// zero padding to a multiple of 8, then one trace_index_t per stride. The
+// writer streams events while the simulation runs and fills in the header
+// and the index when it is closed. Until then the header is all zeros, and
+// readers reject the file as incomplete. A run with no events gives a valid
+// trace with a zero count.
+#define TRACE_MAGIC "SCHEDTL1"
+#define TRACE_VERSION 2
+#define TRACE_STRIDE 1024
+
+typedef struct {
+    char magic[8];          // TRACE_MAGIC (not NUL-terminated)
+    uint32_t version;       // TRACE_VERSION
+    uint32_t stride;        // Events per index entry
+    uint64_t count;         // Events
+    uint64_t data_bytes;    // Encoded events after the header
+    uint64_t index_count;   // ceil(count / stride)
+    int64_t end_time;       // Latest event end
+    uint32_t cpus;          // Highest CPU number + 1
+    uint32_t reserved;      // Zero
+} trace_header_t;
+
+typedef struct {
+    uint64_t offset;        // Byte offset of the entry's first event in the data
+    int32_t time;           // Earliest start of any event from this entry on
+    int32_t end;            // Latest end of any event up to the entry's last one
+} trace_index_t;
+
+// Streams events into a trace file
+typedef struct {
+    FILE *file;
+    uint8_t *buffer;        // Encoded bytes not yet written
+    size_t buffered;
+    uint64_t data_bytes;
+    trace_index_t *index;
+    size_t index_capacity;
+    uint64_t count;
+    timeline_event_t pending;   // Held back so a continuation can merge into it
+    int has_pending;
+    int64_t prev_end;       // Delta state
+    int64_t prev_pid;
+    int64_t end_time;
+    uint32_t cpus;
+    size_t synced;          // Timeline events already taken by trace_writer_sync
+    int failed;
+} trace_writer_t;
+
+// Creates 'path' for writing. Returns 0, or -1 on error (reason printed to
+// stderr).
+int trace_writer_open(trace_writer_t *w, const char *path);
+
+// Appends one event. Returns 0, or -1 once a write has failed.
+int trace_writer_append(trace_writer_t *w, const timeline_event_t *e);
+
+// Appends the events of 'timeline' not yet taken. Unless 'final' is set the
+// last one is left for later, as the engine may still extend it.
+int trace_writer_sync(trace_writer_t *w, const timeline_t *timeline, int final);
+
+// A timeline_observer_fn: install it with timeline_observe(timeline,
+// trace_writer_observer, w) to write the trace while the simulation runs,
+// then call trace_writer_sync(w, timeline, 1) once the run is over.
+int trace_writer_observer(void *ctx, const timeline_t *timeline);
+
+// Writes the index and the header and closes the file. Returns 0, or -1 if
+// any write failed (reason printed to stderr).
+int trace_writer_close(trace_writer_t *w);
+
+// A read-only mapping of a trace file
+typedef struct {
+    const trace_header_t *header;
+    const uint8_t *data;
+    const trace_index_t *index;
+    size_t count;           // Events
+    int end_time;           // Latest event end
+    int cpus;               // CPUs the events ran on
+    void *base;             // Start of the mapping (for munmap)
+    size_t length;          // Mapping length in bytes
+} trace_t;
+
+// Maps a trace file. Returns 0 on success, -1 on error (reason printed to
+// stderr).
+int trace_open(const char *path, trace_t *trace);
+void trace_close(trace_t *trace);
+
+// Sequential decoder over a mapped trace
+typedef struct {
+    const trace_t *trace;
+    size_t next;            // Number of the event trace_next returns
+    uint64_t offset;        // Its byte offset
+    int64_t prev_end;
+    int64_t prev_pid;
+} trace_cursor_t;
+
+// Positions 'c' on event 'event', decoding at most one stride to get there
+void trace_seek(trace_cursor_t *c, const trace_t *trace, size_t event);
+
+// Decodes the next event into 'e'. Returns 1, or 0 at the end of the trace
+// (or if the data is corrupt).
+int trace_next(trace_cursor_t *c, timeline_event_t *e);
+
+// Index of the first event that ends after 'time' (count if none), as
+// gantt_find. One binary search over the index plus at most one stride of
+// decoding. Every event before it ends by 'time'; on a multi-core trace some
+// after it may too.
+size_t trace_find(const trace_t *trace, double time);
+
+// Decodes forward to the next event that overlaps [start, end). Returns 1,
+// or 0 once no later event starts before 'end'. Position the cursor with
+// trace_seek(c, trace, trace_find(trace, start)) first. Works on any trace;
+// on one CPU it stops within a stride of 'end'.
+int trace_next_overlapping(trace_cursor_t *c, double start, double end, timeline_event_t *e);
+
+#endif // TRACE_H
@@ -0,0 +1,68 @@
+#ifndef WORKLOAD_H
+#define WORKLOAD_H
+
+#include <stdint.h>
+#include "scheduler.h"
+
+// --- Binary workload format ---
+// A fixed 24-byte header followed by 16-byte records in host byte order.
+// The file can be mmap'ed and the records used in place.
+#define WORKLOAD_MAGIC "SCHEDWL1"
+#define WORKLOAD_VERSION 1
+
+typedef struct {
+    char magic[8];          // WORKLOAD_MAGIC (not NUL-terminated)
+    uint32_t version;       // WORKLOAD_VERSION
+    uint32_t record_size;   // sizeof(workload_record_t)
+    uint64_t count;         // Number of records that follow
+} workload_header_t;
+
+typedef struct {
+    int32_t pid;
+    int32_t arrival_time;
+    int32_t burst_time;
+    int32_t priority;
+} workload_record_t;
+
+// A read-only mapping of a binary workload file
+typedef struct {
+    const workload_record_t *records;
+    size_t count;
+    void *base;             // Start of the mapping (for munmap)
+    size_t length;          // Mapping length in bytes
+} workload_map_t;
+
+// Loads a workload file. Binary files (starting with WORKLOAD_MAGIC) are
+// mapped and expanded; anything else is read as text, one process per line as
+//   pid arrival burst [priority]
+// separated by spaces, tabs or commas. Blank lines, lines starting with '#'
+// and a non-numeric header line are skipped.
+// On success stores a malloc'd array in *out (caller frees) and returns the
+// process count. Returns -1 on error after printing the reason to stderr.
+int workload_load(const char *path, process_t **out);
+
+// Parses one text workload line by the rules above, for readers that get
+// their lines elsewhere. 'have_records' says whether a record came before,
+// which ends the header row's grace. Returns 1 with the record in *r, 0 for
+// a line to skip, or -1 after printing 'source:line_no: reason' to stderr.
+int workload_parse_line(const char *source, int line_no, const char *line, int have_records,
+                        workload_record_t *r);
+
+// Maps a binary workload and checks every record as the text loader does.
+// Returns 0 on success, -1 on error (reason printed to stderr).
+int workload_map(const char *path, workload_map_t *map);
+void workload_unmap(workload_map_t *map);
+
+// Expands records into a malloc'd process_t array (caller frees).
+// Returns the process count, or -1 if out of memory.
+int workload_from_records(const workload_record_t *records, size_t count, process_t **out);
+
+// Streams a text/CSV workload into the binary format using constant memory,
+// whatever the input size. Returns the number of records written, or -1 on
+// error (reason printed to stderr).
+long long workload_convert(const char *text_path, const char *bin_path);
+
+// Resets the simulation fields of a loaded workload so it can be run again
+void workload_reset(process_t *processes, int n);
+
+#endif // WORKLOAD_H
@@ -0,0 +1,40 @@
+#ifndef WORKLOAD_GEN_H
+#define WORKLOAD_GEN_H
+
+#include <stdint.h>
+#include "scheduler.h"
+
+// Seeded synthetic workload generators
+
+typedef enum {
+    ARRIVAL_POISSON,        // Exponential inter-arrival times
+    ARRIVAL_BURSTY          // Storms: batches of simultaneous arrivals
+} arrival_dist_t;
+
+typedef enum {
+    BURST_EXPONENTIAL,
+    BURST_PARETO            // Heavy-tailed
+} burst_dist_t;
+
+typedef struct {
+    int n;                      // Number of processes
+    arrival_dist_t arrivals;
+    double arrival_rate;        // Mean jobs per time unit
+    double storm_size;          // ARRIVAL_BURSTY: mean jobs per storm
+    burst_dist_t bursts;
+    double burst_mean;          // Mean CPU time per job
+    double pareto_alpha;        // BURST_PARETO shape (> 1; smaller = heavier tail)
+    int max_burst;              // Cap on a single burst (keeps times in int range)
+    int priority_levels;        // Priorities drawn uniformly from [0, levels)
+    uint64_t seed;
+} workload_spec_t;
+
+// Fills 'spec' with a moderately loaded default (Poisson arrivals,
+// exponential bursts, 90% utilization)
+void workload_default_spec(workload_spec_t *spec, int n, uint64_t seed);
+
+// Generates spec->n processes into 'out' (which must hold that many), in
+// arrival order with pids 1..n. The result depends only on the spec.
+void workload_generate(const workload_spec_t *spec, process_t *out);
+
+#endif // WORKLOAD_GEN_H
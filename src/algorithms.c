@@ -1,332 +1,355 @@
 #include <stdio.h>
-#include <stdbool.h>
+#include <limits.h>
 #include "scheduler.h"
+#include "checkpoint.h"
+#include "policy.h"
+#include "instrument.h"
 
 // ------------------------------------------------------
-// Algorithm 1: FIFO (First In First Out)
+// Event-driven core
 // ------------------------------------------------------
-void schedule_fifo(process_t *processes, int n, timeline_event_t *timeline) {
-    int current_time = 0;
-
-    for (int i = 0; i < n; i++) {
-        process_t *p = &processes[i];
-
-        if (p->arrival_time > current_time) {
-            current_time = p->arrival_time;
-        }
-
-        p->start_time = current_time;
-        p->completion_time = p->start_time + p->burst_time;
-
-        p->turnaround_time = p->completion_time - p->arrival_time;
-        p->waiting_time = p->turnaround_time - p->burst_time;
-        p->response_time = p->start_time - p->arrival_time;
-
-        timeline[i].time = p->start_time;
-        timeline[i].pid = p->pid;
-        timeline[i].duration = p->burst_time;
+// One loop runs every policy (see policy.h). The clock only stops at events
+// that can change the decision: a completion, the end of the running job's
+// slice, a priority boost, and an arrival that the policy says preempts the
+// running job. An idle CPU jumps straight to the next arrival, so the cost
+// does not depend on how far apart the timestamps are.
+
+// Result of a scheduler run: events written, or -1 if the run was abandoned
+// because scratch space or the timeline could not be allocated, or the
+// timeline observer asked to stop
+static long run_result(const timeline_t *timeline, int completed, int n) {
+    return completed == n ? (long)timeline->count : -1;
+}
 
-        current_time += p->burst_time;
+// Starts a session snapshot at the top of the loop, or returns NULL when none
+// is due (or there is no memory for one)
+static checkpoint_t *capture(sim_session_t *s, const timeline_t *timeline, const metrics_acc_t *acc,
+                             int current_time, int completed, int next) {
+    if (!checkpoint_due(s, timeline)) return NULL;
+
+    checkpoint_t *cp = checkpoint_begin(s, timeline, acc);
+    if (cp) {
+        cp->time = current_time;
+        cp->completed = completed;
+        cp->next = next;
     }
+    return cp;
 }
 
-// ------------------------------------------------------
-// Algorithm 2: SJF (Shortest Job First)
-// ------------------------------------------------------
-void schedule_sjf(process_t *processes, int n, timeline_event_t *timeline) {
+static long run_policy(proc_table_t *t, sched_policy_t *p, timeline_t *timeline, metrics_acc_t *acc,
+                       sim_session_t *s, const checkpoint_t *from) {
+    const sched_policy_ops_t *ops = p->ops;
+    int n = t->n;
     int current_time = 0;
     int completed = 0;
-    int is_completed[MAX_PROCESSES] = {0};
-    int timeline_index = 0;
-
-    while (completed < n) {
-        int shortest_index = -1;
-        int min_burst = 999999;
-
-        // Find shortest arrived job
-        for (int i = 0; i < n; i++) {
-            if (processes[i].arrival_time <= current_time && !is_completed[i]) {
-                if (processes[i].burst_time < min_burst) {
-                    min_burst = processes[i].burst_time;
-                    shortest_index = i;
-                }
-                else if (processes[i].burst_time == min_burst) {
-                    if (processes[i].arrival_time < processes[shortest_index].arrival_time) {
-                        shortest_index = i;
-                    }
-                }
-            }
-        }
+    int next = 0;   // Cursor into admission order
+    int ready = 0;  // Jobs on the run queue
+
+    // Boosts happen at every multiple of boost_interval
+    long long next_boost = p->boost_interval > 0 ? p->boost_interval : LLONG_MAX;
+
+    SCHED_RESET();
+    if (from) checkpoint_restore(s, from, timeline, acc);
+    else timeline_clear(timeline);
+    if (timeline_reserve(timeline, n) != 0) return -1;
+
+    // Admission order: by arrival, or table order for admit_by_index policies
+    int *order;
+    if (ops->admit_by_index) {
+        order = arena_alloc(p->arena, sizeof(int) * (n > 0 ? n : 1));
+        for (int k = 0; order && k < n; k++) order[k] = k;
+    } else {
+        order = proc_table_arrival_order(t, p->arena);
+    }
+    if (!order) return -1;
+
+    if (from) {
+        current_time = from->time;
+        completed = from->completed;
+        next = from->next;
+        next_boost = from->next_boost;
+        ops->restore(p, 0, s, from);
+        ready = from->entry_count;
+    }
+    // Jobs not admitted yet start untouched
+    for (int k = next; k < n; k++) {
+        int idx = order[k];
+        t->remaining_time[idx] = t->burst_time[idx];
+        if (ops->reset) ops->reset(p, idx);
+    }
 
-        if (shortest_index == -1) {
-            current_time++;
+    while (completed < n && !p->failed) {
+        checkpoint_t *cp = capture(s, timeline, acc, current_time, completed, next);
+        if (cp) {
+            cp->next_boost = next_boost;
+            if (ops->capture(p, 0, s, cp) == 0) checkpoint_commit(s);
         }
-        else {
-            process_t *p = &processes[shortest_index];
 
-            p->start_time = current_time;
-            p->completion_time = p->start_time + p->burst_time;
-
-            p->turnaround_time = p->completion_time - p->arrival_time;
-            p->waiting_time = p->turnaround_time - p->burst_time;
-            p->response_time = p->start_time - p->arrival_time;
-
-            timeline[timeline_index].time = p->start_time;
-            timeline[timeline_index].pid = p->pid;
-            timeline[timeline_index].duration = p->burst_time;
-            timeline_index++;
+        // 1. Admit arrivals
+        while (next < n && t->arrival_time[order[next]] <= current_time) {
+            ops->enqueue(p, 0, order[next++]);
+            ready++;
+        }
 
-            is_completed[shortest_index] = 1;
-            completed++;
-            current_time += p->burst_time;
+        // 2. Priority boost
+        if (current_time >= next_boost) {
+            if (ready > 0) {
+                ops->on_boost(p);
+                SCHED_COUNT(boosts);
+            }
+            next_boost = (current_time / p->boost_interval + 1) * p->boost_interval;
         }
-    }
-}
 
-// ------------------------------------------------------
-// Algorithm 3: STCF (Shortest Time to Completion First)
-// ------------------------------------------------------
-void schedule_stcf(process_t *processes, int n, timeline_event_t *timeline) {
-    int current_time = 0;
-    int completed = 0;
-    int timeline_index = 0;
+        // Idle CPU: jump straight to the next arrival
+        if (ready == 0) {
+            SCHED_ADD(idle_ticks, t->arrival_time[order[next]] - current_time);
+            current_time = t->arrival_time[order[next]];
+            continue;
+        }
 
-    for (int i = 0; i < n; i++) {
-        processes[i].remaining_time = processes[i].burst_time;
-    }
+        // 3. Dispatch
+        SCHED_MAX(ready_high_water, ready);
+        SCHED_TIMER_START(pick);
+        int idx = ops->pick_next(p, 0);
+        SCHED_TIMER_STOP(pick, pick_cycles);
+        SCHED_COUNT(selections);
+        ready--;
 
-    while (completed < n) {
-        int shortest_index = -1;
-        int min_remaining = 999999;
+        if (t->remaining_time[idx] == t->burst_time[idx]) {
+            t->start_time[idx] = current_time;
+        }
 
-        for (int i = 0; i < n; i++) {
-            if (processes[i].arrival_time <= current_time && processes[i].remaining_time > 0) {
-                if (processes[i].remaining_time < min_remaining) {
-                    min_remaining = processes[i].remaining_time;
-                    shortest_index = i;
+        // Run until completion, the end of the slice or the next boost
+        long long run_time = t->remaining_time[idx];
+        int slice = ops->slice(p, idx);
+        if (slice < run_time) run_time = slice;
+        if (next_boost - current_time < run_time) run_time = next_boost - current_time;
+
+        // ...or an arrival that preempts it
+        if (ops->preempts) {
+            while (next < n && t->arrival_time[order[next]] < current_time + run_time) {
+                int at = t->arrival_time[order[next]];
+                while (next < n && t->arrival_time[order[next]] == at) {
+                    ops->enqueue(p, 0, order[next++]);
+                    ready++;
                 }
-                else if (processes[i].remaining_time == min_remaining) {
-                    if (processes[i].arrival_time < processes[shortest_index].arrival_time) {
-                        shortest_index = i;
-                    }
+                if (ops->preempts(p, 0, idx, t->remaining_time[idx] - (at - current_time))) {
+                    run_time = at - current_time;
+                    SCHED_COUNT(preemptions);
+                    break;
                 }
             }
         }
 
-        if (shortest_index == -1) {
-            current_time++;
-        }
-        else {
-            process_t *p = &processes[shortest_index];
-
-            if (p->remaining_time == p->burst_time) {
-                p->start_time = current_time;
-            }
+        SCHED_TIMER_START(account);
+        if (timeline_append(timeline, current_time, t->pid[idx], (int)run_time) != 0) break;
 
-            timeline[timeline_index].time = current_time;
-            timeline[timeline_index].pid = p->pid;
-            timeline[timeline_index].duration = 1;
-            timeline_index++;
+        t->remaining_time[idx] -= (int)run_time;
+        current_time += (int)run_time;
 
-            p->remaining_time--;
-            current_time++;
+        // Jobs arriving during the run queue up ahead of the one being requeued
+        while (next < n && t->arrival_time[order[next]] <= current_time) {
+            ops->enqueue(p, 0, order[next++]);
+            ready++;
+        }
 
-            if (p->remaining_time == 0) {
-                completed++;
-                p->completion_time = current_time;
-                p->turnaround_time = p->completion_time - p->arrival_time;
-                p->waiting_time = p->turnaround_time - p->burst_time;
-                p->response_time = p->start_time - p->arrival_time;
-            }
+        // 4. Completion, or back to the policy
+        if (t->remaining_time[idx] == 0) {
+            completed++;
+            proc_table_finish(t, idx, current_time, acc);
+        } else {
+            ops->on_tick_expiry(p, 0, idx, (int)run_time);
+            ready++;
+            SCHED_COUNT(requeues);
         }
+        SCHED_TIMER_STOP(account, account_cycles);
     }
+    SCHED_ADD(context_switches, timeline->count - (from ? from->events : 0));
+
+    if (s && checkpoint_keep_order(s, ops->admit_by_index ? NULL : order, n) != 0) s->count = 0;
+    arena_release(p->arena, order);
+    return run_result(timeline, completed, n);
 }
 
-// ------------------------------------------------------
-// Algorithm 4: Round Robin
-// ------------------------------------------------------
-void schedule_rr(process_t *processes, int n, int quantum, timeline_event_t *timeline) {
-    int current_time = 0;
-    int completed = 0;
-    int timeline_index = 0;
+long schedule_policy_table(proc_table_t *t, sched_policy_t *p, timeline_t *timeline,
+                           metrics_acc_t *acc) {
+    return run_policy(t, p, timeline, acc, NULL, NULL);
+}
 
-    int queue[MAX_PROCESSES * 10]; // Larger buffer for safety
-    int front = 0;
-    int rear = 0;
+// Builds a one-queue policy for the run and frees it afterwards
+static long run_builtin(const sim_params_t *params, proc_table_t *t, timeline_t *timeline,
+                        metrics_acc_t *acc, sim_session_t *s, const checkpoint_t *from) {
+    sched_policy_t *p = sched_policy_create(params, t, 1, NULL);
+    if (!p) return -1;
+    long events = run_policy(t, p, timeline, acc, s, from);
+    sched_policy_destroy(p);
+    return events;
+}
 
-    int visited[MAX_PROCESSES] = {0};
+long schedule_params_table(const sim_params_t *params, proc_table_t *t, arena_t *arena,
+                           timeline_t *timeline, metrics_acc_t *acc) {
+    arena_reset(arena);
+    sched_policy_t *p = sched_policy_create(params, t, 1, arena);
+    if (!p) return -1;
+    long events = run_policy(t, p, timeline, acc, NULL, NULL);
+    sched_policy_destroy(p);
+    return events;
+}
 
-    for (int i = 0; i < n; i++) {
-        processes[i].remaining_time = processes[i].burst_time;
-    }
+// ------------------------------------------------------
+// Built-in policies (src/policy.c)
+// ------------------------------------------------------
 
-    // Initial fill
-    for (int i = 0; i < n; i++) {
-        if (processes[i].arrival_time == 0) {
-            queue[rear++] = i;
-            visited[i] = 1;
-        }
-    }
+long schedule_fifo_table(proc_table_t *t, timeline_t *timeline, metrics_acc_t *acc) {
+    sim_params_t params = {.policy = SIM_FIFO};
+    return run_builtin(&params, t, timeline, acc, NULL, NULL);
+}
 
-    while (completed < n) {
-        if (front == rear) {
-            int min_arrival = 999999;
-            for(int i=0; i<n; i++) {
-                if(!visited[i] && processes[i].arrival_time < min_arrival) {
-                    min_arrival = processes[i].arrival_time;
-                }
-            }
-            if (min_arrival < 999999) current_time = min_arrival;
-            else current_time++;
+long schedule_sjf_table(proc_table_t *t, timeline_t *timeline, metrics_acc_t *acc) {
+    sim_params_t params = {.policy = SIM_SJF};
+    return run_builtin(&params, t, timeline, acc, NULL, NULL);
+}
 
-            for (int i = 0; i < n; i++) {
-                if (processes[i].arrival_time <= current_time && !visited[i]) {
-                    queue[rear++] = i;
-                    visited[i] = 1;
-                }
-            }
-            continue;
-        }
+long schedule_stcf_table(proc_table_t *t, timeline_t *timeline, metrics_acc_t *acc) {
+    sim_params_t params = {.policy = SIM_STCF};
+    return run_builtin(&params, t, timeline, acc, NULL, NULL);
+}
 
-        int idx = queue[front++];
-        process_t *p = &processes[idx];
+long schedule_rr_table(proc_table_t *t, int quantum, timeline_t *timeline, metrics_acc_t *acc) {
+    sim_params_t params = {.policy = SIM_RR, .quantum = quantum};
+    return run_builtin(&params, t, timeline, acc, NULL, NULL);
+}
 
-        if (p->remaining_time == p->burst_time) {
-            p->start_time = current_time;
-        }
+long schedule_mlfq_table(proc_table_t *t, mlfq_config_t *config, timeline_t *timeline,
+                         metrics_acc_t *acc) {
+    sim_params_t params = {.policy = SIM_MLFQ, .mlfq = config};
+    return run_builtin(&params, t, timeline, acc, NULL, NULL);
+}
 
-        int run_time = (p->remaining_time > quantum) ? quantum : p->remaining_time;
+long schedule_cfs_table(proc_table_t *t, const cfs_config_t *config, timeline_t *timeline,
+                        metrics_acc_t *acc) {
+    sim_params_t params = {.policy = SIM_CFS, .cfs = config};
+    return run_builtin(&params, t, timeline, acc, NULL, NULL);
+}
 
-        timeline[timeline_index].time = current_time;
-        timeline[timeline_index].pid = p->pid;
-        timeline[timeline_index].duration = run_time;
-        timeline_index++;
+long schedule_lottery_table(proc_table_t *t, int quantum, uint64_t seed, timeline_t *timeline,
+                            metrics_acc_t *acc) {
+    sim_params_t params = {.policy = SIM_LOTTERY, .quantum = quantum, .seed = seed};
+    return run_builtin(&params, t, timeline, acc, NULL, NULL);
+}
 
-        current_time += run_time;
-        p->remaining_time -= run_time;
+long schedule_stride_table(proc_table_t *t, int quantum, timeline_t *timeline, metrics_acc_t *acc) {
+    sim_params_t params = {.policy = SIM_STRIDE, .quantum = quantum};
+    return run_builtin(&params, t, timeline, acc, NULL, NULL);
+}
 
-        for (int i = 0; i < n; i++) {
-            if (processes[i].arrival_time <= current_time && !visited[i]) {
-                queue[rear++] = i;
-                visited[i] = 1;
-            }
-        }
+long schedule_priority_table(proc_table_t *t, int preemptive, int aging_interval, timeline_t *timeline,
+                             metrics_acc_t *acc) {
+    sim_params_t params = {.policy = preemptive ? SIM_PRIORITY_PREEMPT : SIM_PRIORITY,
+                           .aging_interval = aging_interval};
+    return run_builtin(&params, t, timeline, acc, NULL, NULL);
+}
 
-        if (p->remaining_time > 0) {
-            queue[rear++] = idx;
-        } else {
-            completed++;
-            p->completion_time = current_time;
-            p->turnaround_time = p->completion_time - p->arrival_time;
-            p->waiting_time = p->turnaround_time - p->burst_time;
-            p->response_time = p->start_time - p->arrival_time;
-        }
-    }
+// ------------------------------------------------------
+// Checkpointed sessions (see checkpoint.h)
+// ------------------------------------------------------
+
+long schedule_session(sim_session_t *s, proc_table_t *t, timeline_t *timeline,
+                      metrics_acc_t *acc, const checkpoint_t *from) {
+    mlfq_config_t mlfq = {s->mlfq_queues, s->mlfq_quantums, s->boost_interval};
+    sim_params_t params = {.policy = s->policy, .quantum = s->quantum, .mlfq = &mlfq, .cfs = &s->cfs,
+                           .seed = s->seed, .aging_interval = s->aging_interval};
+    return run_builtin(&params, t, timeline, acc, s, from);
 }
 
+
 // ------------------------------------------------------
-// Algorithm 5: MLFQ (Multi-Level Feedback Queue)
+// process_t array API
 // ------------------------------------------------------
-void schedule_mlfq(process_t *processes, int n, mlfq_config_t *config, timeline_event_t *timeline) {
-    int current_time = 0;
-    int completed = 0;
-    int timeline_index = 0;
+// Each wrapper copies the array into a table, runs the table engine and
+// copies the results back.
+
+long schedule_fifo(process_t *processes, int n, timeline_t *timeline, metrics_acc_t *acc) {
+    proc_table_t t;
+    if (proc_table_from_array(&t, processes, n) != 0) return -1;
+    long events = schedule_fifo_table(&t, timeline, acc);
+    proc_table_to_array(&t, processes);
+    proc_table_free(&t);
+    return events;
+}
 
-    // Track how much quantum used at current level
-    int time_slice_used[MAX_PROCESSES] = {0};
+long schedule_sjf(process_t *processes, int n, timeline_t *timeline, metrics_acc_t *acc) {
+    proc_table_t t;
+    if (proc_table_from_array(&t, processes, n) != 0) return -1;
+    long events = schedule_sjf_table(&t, timeline, acc);
+    proc_table_to_array(&t, processes);
+    proc_table_free(&t);
+    return events;
+}
 
-    // Initialize processes
-    for (int i = 0; i < n; i++) {
-        processes[i].remaining_time = processes[i].burst_time;
-        processes[i].priority = 0; // Start at highest priority (0)
-        time_slice_used[i] = 0;
-    }
+long schedule_stcf(process_t *processes, int n, timeline_t *timeline, metrics_acc_t *acc) {
+    proc_table_t t;
+    if (proc_table_from_array(&t, processes, n) != 0) return -1;
+    long events = schedule_stcf_table(&t, timeline, acc);
+    proc_table_to_array(&t, processes);
+    proc_table_free(&t);
+    return events;
+}
 
-    int time_since_boost = 0;
+long schedule_rr(process_t *processes, int n, int quantum, timeline_t *timeline, metrics_acc_t *acc) {
+    proc_table_t t;
+    if (proc_table_from_array(&t, processes, n) != 0) return -1;
+    long events = schedule_rr_table(&t, quantum, timeline, acc);
+    proc_table_to_array(&t, processes);
+    proc_table_free(&t);
+    return events;
+}
 
-    while (completed < n) {
-        // 1. Check for Priority Boost
-        if (time_since_boost >= config->boost_interval) {
-            for (int i = 0; i < n; i++) {
-                if (processes[i].remaining_time > 0) {
-                    processes[i].priority = 0;
-                    time_slice_used[i] = 0;
-                }
-            }
-            time_since_boost = 0;
-        }
+long schedule_mlfq(process_t *processes, int n, mlfq_config_t *config, timeline_t *timeline,
+                   metrics_acc_t *acc) {
+    proc_table_t t;
+    if (proc_table_from_array(&t, processes, n) != 0) return -1;
+    long events = schedule_mlfq_table(&t, config, timeline, acc);
+    proc_table_to_array(&t, processes);
+    proc_table_free(&t);
+    return events;
+}
 
-        // 2. Find process to run: Highest Priority (lowest value) that has arrived
-        int selected_idx = -1;
-        int highest_prio = 999;
-
-        // Iterate through priority queues (0 to num_queues-1)
-        for (int q = 0; q < config->num_queues; q++) {
-            bool found_in_queue = false;
-
-            // Check all processes to see if any are in this queue and ready
-            // (Note: In a real OS, we'd have actual queues. Here we scan.)
-            for (int i = 0; i < n; i++) {
-                if (processes[i].arrival_time <= current_time &&
-                    processes[i].remaining_time > 0 &&
-                    processes[i].priority == q) {
-
-                    // Found a candidate.
-                    // To strictly follow Round Robin within queue, we should track "last run".
-                    // For this sim, we pick the first one found (FCFS within priority)
-                    // or implement a simple pointer rotation if needed.
-                    selected_idx = i;
-                    highest_prio = q;
-                    found_in_queue = true;
-                    break;
-                }
-            }
-            if (found_in_queue) break;
-        }
+long schedule_cfs(process_t *processes, int n, const cfs_config_t *config, timeline_t *timeline,
+                  metrics_acc_t *acc) {
+    proc_table_t t;
+    if (proc_table_from_array(&t, processes, n) != 0) return -1;
+    long events = schedule_cfs_table(&t, config, timeline, acc);
+    proc_table_to_array(&t, processes);
+    proc_table_free(&t);
+    return events;
+}
 
-        // 3. Run Logic
-        if (selected_idx == -1) {
-            current_time++;
-            time_since_boost++;
-        }
-        else {
-            process_t *p = &processes[selected_idx];
+long schedule_lottery(process_t *processes, int n, int quantum, uint64_t seed, timeline_t *timeline,
+                      metrics_acc_t *acc) {
+    proc_table_t t;
+    if (proc_table_from_array(&t, processes, n) != 0) return -1;
+    long events = schedule_lottery_table(&t, quantum, seed, timeline, acc);
+    proc_table_to_array(&t, processes);
+    proc_table_free(&t);
+    return events;
+}
 
-            if (p->remaining_time == p->burst_time) {
-                p->start_time = current_time;
-            }
+long schedule_stride(process_t *processes, int n, int quantum, timeline_t *timeline, metrics_acc_t *acc) {
+    proc_table_t t;
+    if (proc_table_from_array(&t, processes, n) != 0) return -1;
+    long events = schedule_stride_table(&t, quantum, timeline, acc);
+    proc_table_to_array(&t, processes);
+    proc_table_free(&t);
+    return events;
+}
 
-            // Run for 1 tick
-            timeline[timeline_index].time = current_time;
-            timeline[timeline_index].pid = p->pid;
-            timeline[timeline_index].duration = 1;
-            timeline_index++;
-
-            p->remaining_time--;
-            time_slice_used[selected_idx]++;
-            current_time++;
-            time_since_boost++;
-
-            // Check completion
-            if (p->remaining_time == 0) {
-                completed++;
-                p->completion_time = current_time;
-                p->turnaround_time = p->completion_time - p->arrival_time;
-                p->waiting_time = p->turnaround_time - p->burst_time;
-                p->response_time = p->start_time - p->arrival_time;
-            }
-            else {
-                // Check if quantum exceeded for this level
-                int current_quantum = config->quantums[p->priority];
-                if (time_slice_used[selected_idx] >= current_quantum) {
-                    // Downgrade priority if not already at bottom
-                    if (p->priority < config->num_queues - 1) {
-                        p->priority++;
-                    }
-                    // Reset slice usage for new level
-                    time_slice_used[selected_idx] = 0;
-                }
-            }
-        }
-    }
+long schedule_priority(process_t *processes, int n, int preemptive, int aging_interval,
+                       timeline_t *timeline, metrics_acc_t *acc) {
+    proc_table_t t;
+    if (proc_table_from_array(&t, processes, n) != 0) return -1;
+    long events = schedule_priority_table(&t, preemptive, aging_interval, timeline, acc);
+    proc_table_to_array(&t, processes);
+    proc_table_free(&t);
+    return events;
 }
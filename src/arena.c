@@ -0,0 +1,98 @@
+#include <stdlib.h>
+#include <string.h>
+#include "arena.h"
+
+#define ARENA_ALIGN 64
+
+struct arena_block {
+    arena_block_t *next;
+};
+
+static size_t align_up(size_t bytes) {
+    return (bytes + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1);
+}
+
+void arena_init(arena_t *a) {
+    memset(a, 0, sizeof(*a));
+}
+
+static void free_overflow(arena_t *a) {
+    while (a->overflow) {
+        arena_block_t *next = a->overflow->next;
+        free(a->overflow);
+        a->overflow = next;
+    }
+}
+
+void arena_free(arena_t *a) {
+    free_overflow(a);
+    free(a->base);
+    arena_init(a);
+}
+
+int arena_reserve(arena_t *a, size_t bytes) {
+    if (!a) return 0;
+
+    bytes = align_up(bytes);
+    if (bytes <= a->size) return 0;
+
+    char *base = aligned_alloc(ARENA_ALIGN, bytes);
+    if (!base) return -1;
+    free(a->base);
+    a->base = base;
+    a->size = bytes;
+    a->used = 0;
+    return 0;
+}
+
+void arena_reset(arena_t *a) {
+    if (!a) return;
+
+    // Only after a run that overflowed: make the next one fit in one block.
+    // If that fails the overflow path keeps working, just without the reuse.
+    if (a->overflow) {
+        free_overflow(a);
+        arena_reserve(a, a->needed);
+    }
+    a->used = 0;
+    a->needed = 0;
+}
+
+void *arena_alloc(arena_t *a, size_t bytes) {
+    if (!a) return malloc(bytes > 0 ? bytes : 1);
+
+    bytes = align_up(bytes > 0 ? bytes : 1);
+    a->needed += bytes;
+    if (a->size - a->used >= bytes) {
+        void *p = a->base + a->used;
+        a->used += bytes;
+        return p;
+    }
+
+    // The block header takes one aligned slot in front of the data
+    arena_block_t *block = aligned_alloc(ARENA_ALIGN, ARENA_ALIGN + bytes);
+    if (!block) return NULL;
+    block->next = a->overflow;
+    a->overflow = block;
+    return (char *)block + ARENA_ALIGN;
+}
+
+void *arena_calloc(arena_t *a, size_t count, size_t size) {
+    if (!a) return calloc(count > 0 ? count : 1, size);
+
+    void *p = arena_alloc(a, count * size);
+    if (p) memset(p, 0, count * size);
+    return p;
+}
+
+void *arena_realloc(arena_t *a, void *ptr, size_t old_bytes, size_t new_bytes) {
+    if (!a) return realloc(ptr, new_bytes);
+
+    void *p = arena_alloc(a, new_bytes);
+    if (p && ptr) memcpy(p, ptr, old_bytes < new_bytes ? old_bytes : new_bytes);
+    return p;
+}
+
+void arena_release(arena_t *a, void *ptr) {
+    if (!a) free(ptr);
+}
@@ -0,0 +1,179 @@
+#include <string.h>
+#include "checkpoint.h"
+
+void sim_session_init(sim_session_t *s, const sim_params_t *params) {
+    const mlfq_config_t *mlfq = params->mlfq;
+
+    memset(s, 0, sizeof(*s));
+    s->policy = params->policy;
+    s->quantum = params->quantum;
+    if (mlfq) {
+        s->mlfq_queues = mlfq->num_queues;
+        if (s->mlfq_queues < 1) s->mlfq_queues = 1;
+        if (s->mlfq_queues > MLFQ_MAX_QUEUES) s->mlfq_queues = MLFQ_MAX_QUEUES;
+        memcpy(s->mlfq_quantums, mlfq->quantums, sizeof(int) * s->mlfq_queues);
+        s->boost_interval = mlfq->boost_interval;
+    }
+    if (params->cfs) s->cfs = *params->cfs;
+    else cfs_default_config(&s->cfs);
+    s->seed = params->seed;
+    s->aging_interval = params->aging_interval;
+    s->interval = TIMELINE_CHUNK;
+}
+
+void sim_session_free(sim_session_t *s) {
+    free(s->checkpoints);
+    free(s->entries);
+    free(s->order);
+    s->checkpoints = NULL;
+    s->entries = NULL;
+    s->order = NULL;
+    s->count = 0;
+}
+
+// ------------------------------------------------------
+// Capture
+// ------------------------------------------------------
+
+// Keeps snapshots 0, 2, 4, ... and packs their entries to the front
+static void thin_checkpoints(sim_session_t *s) {
+    size_t entries = 0;
+    int kept = 0;
+
+    for (int i = 0; i < s->count; i += 2) {
+        checkpoint_t *cp = &s->checkpoints[i];
+        memmove(&s->entries[entries], &s->entries[cp->first_entry],
+                sizeof(checkpoint_entry_t) * cp->entry_count);
+        cp->first_entry = entries;
+        entries += cp->entry_count;
+        if (kept != i) s->checkpoints[kept] = *cp;
+        kept++;
+    }
+    s->count = kept;
+    s->entry_count = entries;
+    s->interval *= 2;
+}
+
+checkpoint_t *checkpoint_begin(sim_session_t *s, const timeline_t *timeline, const metrics_acc_t *acc) {
+    if (!s->checkpoints) {
+        s->checkpoints = malloc(sizeof(checkpoint_t) * CHECKPOINT_MAX);
+        if (!s->checkpoints) {
+            s->next_capture = timeline->count + s->interval;
+            return NULL;
+        }
+    }
+    if (s->count == CHECKPOINT_MAX) thin_checkpoints(s);
+
+    checkpoint_t *cp = &s->checkpoints[s->count];
+    cp->events = timeline->count;
+    cp->last_duration = timeline->count ? timeline->events[timeline->count - 1].duration : 0;
+    cp->first_entry = s->entry_count;
+    cp->entry_count = 0;
+    cp->next_boost = 0;
+    cp->boost_epoch = 0;
+    if (acc) cp->acc = *acc;
+    return cp;
+}
+
+int checkpoint_add(sim_session_t *s, checkpoint_t *cp, const checkpoint_entry_t *entry) {
+    if (s->entry_count == s->entry_capacity) {
+        size_t grown = s->entry_capacity ? s->entry_capacity * 2 : 256;
+        checkpoint_entry_t *entries = realloc(s->entries, sizeof(checkpoint_entry_t) * grown);
+        if (!entries) {
+            // Abandon this snapshot; the previous ones stay usable
+            s->entry_count = cp->first_entry;
+            s->next_capture = cp->events + s->interval;
+            return -1;
+        }
+        s->entries = entries;
+        s->entry_capacity = grown;
+    }
+    s->entries[s->entry_count++] = *entry;
+    cp->entry_count++;
+    return 0;
+}
+
+void checkpoint_commit(sim_session_t *s) {
+    s->count++;
+    s->next_capture = s->checkpoints[s->count - 1].events + s->interval;
+}
+
+void checkpoint_restore(sim_session_t *s, const checkpoint_t *from, timeline_t *timeline,
+                        metrics_acc_t *acc) {
+    timeline->count = from->events;
+    if (from->events > 0) timeline->events[from->events - 1].duration = from->last_duration;
+    timeline->published = from->events > 0 ? from->events - 1 : 0;
+    if (acc) *acc = from->acc;
+
+    // Snapshots after 'from' describe the old run
+    int keep = (int)(from - s->checkpoints) + 1;
+    s->count = keep;
+    s->entry_count = from->first_entry + from->entry_count;
+    s->next_capture = from->events + s->interval;
+}
+
+int checkpoint_keep_order(sim_session_t *s, const int *order, int n) {
+    s->n = n;
+    if (!order) {
+        free(s->order);
+        s->order = NULL;
+        return 0;
+    }
+
+    int *copy = realloc(s->order, sizeof(int) * (n > 0 ? n : 1));
+    if (!copy) return -1;
+    memcpy(copy, order, sizeof(int) * n);
+    s->order = copy;
+    return 0;
+}
+
+// ------------------------------------------------------
+// Runs
+// ------------------------------------------------------
+
+long sim_session_run(sim_session_t *s, proc_table_t *t, timeline_t *timeline, metrics_acc_t *acc) {
+    s->count = 0;
+    s->entry_count = 0;
+    s->interval = TIMELINE_CHUNK;
+    s->next_capture = s->interval;
+    s->has_acc = acc != NULL;
+
+    long events = schedule_session(s, t, timeline, acc, NULL);
+    if (events < 0) s->count = 0;
+    return events;
+}
+
+// A snapshot can be resumed from if 'idx' had not been admitted yet, and
+// its new arrival is after the snapshot. One at the snapshot's own time is
+// not enough: a fresh run would have queued it ahead of the job requeued
+// there.
+static int usable(const proc_table_t *t, const checkpoint_t *cp, int idx, int position) {
+    return cp->next <= position && t->arrival_time[idx] > cp->time;
+}
+
+long sim_session_rerun(sim_session_t *s, proc_table_t *t, int idx, timeline_t *timeline,
+                       metrics_acc_t *acc, int *resumed_at) {
+    const checkpoint_t *from = NULL;
+
+    if (s->n == t->n && idx >= 0 && idx < t->n && (acc != NULL) == s->has_acc) {
+        // Position of 'idx' in the previous run's admission order
+        int position = idx;
+        if (s->order) {
+            for (position = 0; position < s->n && s->order[position] != idx; position++) {}
+        }
+        for (int c = s->count - 1; c >= 0 && !from; c--) {
+            if (usable(t, &s->checkpoints[c], idx, position)) from = &s->checkpoints[c];
+        }
+    }
+
+    if (resumed_at) *resumed_at = from ? from->time : 0;
+    if (!from) {
+        // 'acc' holds the previous run's totals
+        if (acc) metrics_acc_init(acc);
+        return sim_session_run(s, t, timeline, acc);
+    }
+
+    long events = schedule_session(s, t, timeline, acc, from);
+    if (events < 0) s->count = 0;
+    return events;
+}
@@ -0,0 +1,55 @@
+#include <stdlib.h>
+#include <string.h>
+#include "fenwick.h"
+
+int fenwick_init(fenwick_t *f, int capacity, arena_t *arena) {
+    int size = 1;
+    while (size < capacity) size *= 2;
+
+    f->arena = arena;
+    f->tree = arena_calloc(arena, (size_t)size + 1, sizeof(long long));
+    f->capacity = size;
+    return f->tree ? 0 : -1;
+}
+
+void fenwick_free(fenwick_t *f) {
+    arena_release(f->arena, f->tree);
+    f->tree = NULL;
+    f->capacity = 0;
+}
+
+// Doubling a power-of-two tree leaves every old node valid. The new nodes
+// cover empty slots, except the new root, which covers everything.
+int fenwick_reserve(fenwick_t *f, int capacity) {
+    int size = f->capacity;
+    while (size < capacity) size *= 2;
+    if (size == f->capacity) return 0;
+
+    long long *tree = arena_realloc(f->arena, f->tree, sizeof(long long) * ((size_t)f->capacity + 1),
+                                    sizeof(long long) * ((size_t)size + 1));
+    if (!tree) return -1;
+
+    long long total = tree[f->capacity];
+    memset(&tree[f->capacity + 1], 0, sizeof(long long) * (size - f->capacity));
+    for (int root = f->capacity * 2; root <= size; root *= 2) tree[root] = total;
+    f->tree = tree;
+    f->capacity = size;
+    return 0;
+}
+
+void fenwick_add(fenwick_t *f, int slot, long long delta) {
+    for (int i = slot + 1; i <= f->capacity; i += i & -i) f->tree[i] += delta;
+}
+
+// Binary lifting: descend from the root, skipping every block whose sum
+// still fits under 'target'
+int fenwick_find(const fenwick_t *f, long long target) {
+    int pos = 0;
+    for (int step = f->capacity; step > 0; step /= 2) {
+        if (f->tree[pos + step] <= target) {
+            pos += step;
+            target -= f->tree[pos];
+        }
+    }
+    return pos;
+}
@@ -0,0 +1,204 @@
+#include <limits.h>
+#include <math.h>
+#include "gantt.h"
+
+// ------------------------------------------------------
+// View control
+// ------------------------------------------------------
+
+// Narrowest window: one time unit across the chart
+#define GANTT_MIN_SPAN 1.0
+
+void gantt_view_clamp(gantt_view_t *view, int total_time) {
+    double total = total_time > 0 ? total_time : GANTT_MIN_SPAN;
+    double min_span = total < GANTT_MIN_SPAN ? total : GANTT_MIN_SPAN;
+
+    if (view->span > total) view->span = total;
+    if (view->span < min_span) view->span = min_span;
+    if (view->start > total - view->span) view->start = total - view->span;
+    if (view->start < 0) view->start = 0;
+}
+
+void gantt_view_fit(gantt_view_t *view, int total_time) {
+    view->start = 0;
+    view->span = total_time > 0 ? total_time : GANTT_MIN_SPAN;
+}
+
+void gantt_view_zoom(gantt_view_t *view, double factor, double anchor, int total_time) {
+    if (factor <= 0) return;
+
+    // Keep the time under 'anchor' at the same screen position
+    double fraction = (anchor - view->start) / view->span;
+    view->span /= factor;
+    gantt_view_clamp(view, total_time);
+    view->start = anchor - fraction * view->span;
+    gantt_view_clamp(view, total_time);
+}
+
+void gantt_view_pan(gantt_view_t *view, double delta, int total_time) {
+    view->start += delta;
+    gantt_view_clamp(view, total_time);
+}
+
+// ------------------------------------------------------
+// Layout
+// ------------------------------------------------------
+
+size_t gantt_find(const timeline_t *timeline, double time) {
+    size_t lo = 0, hi = timeline->count;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        const timeline_event_t *e = &timeline->events[mid];
+        if (e->time + e->duration > time) hi = mid;
+        else lo = mid + 1;
+    }
+    return lo;
+}
+
+void gantt_layout_init(gantt_layout_t *layout) {
+    layout->bars = NULL;
+    layout->count = 0;
+    layout->capacity = 0;
+}
+
+void gantt_layout_free(gantt_layout_t *layout) {
+    free(layout->bars);
+    gantt_layout_init(layout);
+}
+
+static int push_bar(gantt_layout_t *layout, double x, double width, int pid) {
+    // Touching bars of the same process become one
+    if (layout->count > 0) {
+        gantt_bar_t *last = &layout->bars[layout->count - 1];
+        if (last->pid == pid && x - (last->x + last->width) < 0.5) {
+            last->width = x + width - last->x;
+            return 0;
+        }
+    }
+
+    if (layout->count == layout->capacity) {
+        size_t grown = layout->capacity ? layout->capacity * 2 : 256;
+        gantt_bar_t *bars = realloc(layout->bars, grown * sizeof(gantt_bar_t));
+        if (!bars) return -1;
+        layout->bars = bars;
+        layout->capacity = grown;
+    }
+
+    gantt_bar_t *b = &layout->bars[layout->count++];
+    b->x = x;
+    b->width = width;
+    b->pid = pid;
+    return 0;
+}
+
+// Where a layout reads its events: an in-memory timeline, or a mapped trace
+// decoded through a cursor. Layout walks forward with occasional jumps, so
+// most trace reads continue from the cursor instead of seeking.
+typedef struct {
+    const timeline_t *timeline;
+    const trace_t *trace;
+    trace_cursor_t cursor;
+    timeline_event_t current;   // Trace event cursor.next - 1
+} event_source_t;
+
+static size_t source_count(const event_source_t *s) {
+    return s->timeline ? s->timeline->count : s->trace->count;
+}
+
+static size_t source_find(const event_source_t *s, double time) {
+    return s->timeline ? gantt_find(s->timeline, time) : trace_find(s->trace, time);
+}
+
+static const timeline_event_t *source_get(event_source_t *s, size_t i) {
+    if (s->timeline) return &s->timeline->events[i];
+
+    trace_cursor_t *c = &s->cursor;
+    if (c->next > 0 && i == c->next - 1) return &s->current;
+    if (i < c->next || i - c->next >= s->trace->header->stride) trace_seek(c, s->trace, i);
+    while (c->next <= i) {
+        if (!trace_next(c, &s->current)) {
+            // Corrupt data: show an empty slice rather than stale bytes
+            s->current = (timeline_event_t){0};
+            break;
+        }
+    }
+    return &s->current;
+}
+
+static int layout_build(gantt_layout_t *layout, event_source_t *src, const gantt_view_t *view,
+                        double width) {
+    layout->count = 0;
+    size_t count = source_count(src);
+    if (count == 0 || view->span <= 0 || width <= 0) return 0;
+
+    double scale = width / view->span;
+    double end = view->start + view->span;
+    double edge = 0;        // Pixels already covered by earlier bars
+    size_t i = source_find(src, view->start);
+
+    while (i < count) {
+        timeline_event_t e = *source_get(src, i);
+        if (e.time >= end) break;
+
+        double x0 = (e.time - view->start) * scale;
+        double x1 = (e.time + e.duration - view->start) * scale;
+        if (x0 < edge) x0 = edge;
+        if (x1 > width) x1 = width;
+
+        double column = floor(x0);
+        if (x1 - x0 >= 1 || x1 > column + 1) {
+            // Wide enough to draw on its own, or it crosses into the next column
+            if (push_bar(layout, x0, x1 - x0, e.pid) != 0) return -1;
+            edge = x1;
+            i++;
+            continue;
+        }
+
+        // Everything that ends inside this pixel column becomes one bar.
+        // Contiguous slices of a process are already coalesced in the
+        // timeline, so more than two events here means several processes.
+        double column_end = view->start + (column + 1) / scale;
+        size_t j = source_find(src, column_end);
+        if (j <= i) j = i + 1;  // Rounding put the end of 'e' just past the column
+        size_t last = (j < count && source_get(src, j)->time < column_end) ? j : j - 1;
+        int pid = e.pid;
+        if (last > i + 1 || source_get(src, last)->pid != pid) pid = GANTT_MIXED;
+
+        double right = column + 1 < width ? column + 1 : width;
+        if (push_bar(layout, x0, right - x0, pid) != 0) return -1;
+        edge = right;
+        i = j;
+    }
+    return 0;
+}
+
+int gantt_layout_build(gantt_layout_t *layout, const timeline_t *timeline,
+                       const gantt_view_t *view, double width) {
+    event_source_t src = {.timeline = timeline};
+    return layout_build(layout, &src, view, width);
+}
+
+int gantt_layout_build_trace(gantt_layout_t *layout, const trace_t *trace,
+                             const gantt_view_t *view, double width) {
+    layout->count = 0;
+    if (trace->cpus > 1) return 0;
+
+    event_source_t src = {.trace = trace};
+    trace_seek(&src.cursor, trace, 0);
+    return layout_build(layout, &src, view, width);
+}
+
+int gantt_tick_step(const gantt_view_t *view, double width, double min_spacing) {
+    if (width <= 0) return 1;
+
+    double raw = view->span * min_spacing / width;
+    if (raw <= 1) return 1;
+
+    double magnitude = pow(10, floor(log10(raw)));
+    static const int steps[] = {1, 2, 5, 10};
+    for (int s = 0; s < 4; s++) {
+        double step = steps[s] * magnitude;
+        if (step >= raw) return step < INT_MAX ? (int)step : INT_MAX;
+    }
+    return INT_MAX;
+}
@@ -0,0 +1,28 @@
+#include "instrument.h"
+
+#ifdef SCHED_INSTRUMENT
+
+#define COUNTER_FIELD(name) {#name, offsetof(sched_counters_t, name)}
+
+const sched_counter_field_t sched_counter_fields[SCHED_COUNTER_FIELDS] = {
+    COUNTER_FIELD(selections),
+    COUNTER_FIELD(context_switches),
+    COUNTER_FIELD(preemptions),
+    COUNTER_FIELD(requeues),
+    COUNTER_FIELD(boosts),
+    COUNTER_FIELD(demotions),
+    COUNTER_FIELD(queue_steps),
+    COUNTER_FIELD(idle_ticks),
+    COUNTER_FIELD(ready_high_water),
+    COUNTER_FIELD(pick_cycles),
+    COUNTER_FIELD(account_cycles),
+};
+
+_Thread_local sched_counters_t sched_counters;
+
+#else
+
+// ISO C wants at least one declaration per translation unit
+typedef int instrument_disabled_t;
+
+#endif // SCHED_INSTRUMENT
@@ -0,0 +1,197 @@
+#include <string.h>
+#include "libscheduler.h"
+#include "policy.h"
+#include "smp.h"
+#include "threadpool.h"
+#include "scratch.h"
+
+// The ABI mirrors the simulator's ids and limits
+_Static_assert(SCHED_POLICY_COUNT == SIM_POLICY_COUNT, "policy ids out of step");
+_Static_assert(SCHED_POLICY_PRIORITY_PREEMPT == (int)SIM_PRIORITY_PREEMPT, "policy ids out of step");
+_Static_assert(SCHED_BALANCE_STEAL == (int)SMP_STEAL, "balance modes out of step");
+_Static_assert(SCHED_MLFQ_MAX_LEVELS == MLFQ_MAX_QUEUES, "MLFQ limit out of step");
+_Static_assert(SCHED_MAX_CPUS == SMP_MAX_CPUS, "CPU limit out of step");
+
+static const char *policy_names[SCHED_POLICY_COUNT] = {
+    "FIFO", "SJF", "STCF", "Round Robin", "MLFQ", "CFS", "Lottery", "Stride", "Priority", "Priority (P)"
+};
+
+typedef struct {
+    const sched_workload_t *workloads;
+    const sched_config_t *configs;
+    size_t config_count;
+    sched_result_t *results;
+    worker_scratch_t *workers;  // Reused for every run a worker takes
+} batch_t;
+
+int sched_abi_version(void) {
+    return SCHED_ABI_VERSION;
+}
+
+const char *sched_policy_name(int32_t policy) {
+    return policy >= 0 && policy < SCHED_POLICY_COUNT ? policy_names[policy] : NULL;
+}
+
+void sched_config_default(sched_config_t *config, int32_t policy) {
+    cfs_config_t cfs;
+    cfs_default_config(&cfs);
+
+    memset(config, 0, sizeof(*config));
+    config->policy = policy;
+    config->quantum = 3;
+    config->mlfq_levels = 3;
+    config->mlfq_quantums[0] = 2;
+    config->mlfq_quantums[1] = 4;
+    config->mlfq_quantums[2] = 8;
+    config->mlfq_boost_interval = 10;
+    config->cfs_latency = cfs.sched_latency;
+    config->cfs_granularity = cfs.min_granularity;
+    config->cpus = 1;
+    config->balance = SCHED_BALANCE_STEAL;
+    config->balance_interval = 10;
+    config->seed = 1;
+}
+
+static int config_valid(const sched_config_t *c) {
+    if (c->policy < 0 || c->policy >= SCHED_POLICY_COUNT) return 0;
+    if (c->cpus < 1 || c->cpus > SCHED_MAX_CPUS) return 0;
+    if (c->cpus > 1 && (c->balance < SCHED_BALANCE_GLOBAL || c->balance > SCHED_BALANCE_STEAL ||
+                        (c->balance == SCHED_BALANCE_PUSH && c->balance_interval < 1))) {
+        return 0;
+    }
+
+    switch (c->policy) {
+        case SCHED_POLICY_RR:
+        case SCHED_POLICY_LOTTERY:
+        case SCHED_POLICY_STRIDE:
+            return c->quantum >= 1;
+        case SCHED_POLICY_MLFQ:
+            if (c->mlfq_levels < 1 || c->mlfq_levels > SCHED_MLFQ_MAX_LEVELS || c->mlfq_boost_interval < 0) {
+                return 0;
+            }
+            for (int l = 0; l < c->mlfq_levels; l++) {
+                if (c->mlfq_quantums[l] < 1) return 0;
+            }
+            return 1;
+        case SCHED_POLICY_CFS:
+            return c->cfs_latency >= 1 && c->cfs_granularity >= 1;
+        case SCHED_POLICY_PRIORITY:
+        case SCHED_POLICY_PRIORITY_PREEMPT:
+            return c->aging_interval >= 0;
+        default:
+            return 1;
+    }
+}
+
+// Copies the jobs into the worker's table, growing it if needed. Returns
+// SCHED_OK or the status to report.
+static int load_workload(worker_scratch_t *w, const sched_workload_t *wl) {
+    if (wl->count < 0 || (wl->count > 0 && !wl->jobs)) return SCHED_EINVAL;
+    for (int i = 0; i < wl->count; i++) {
+        if (wl->jobs[i].arrival_time < 0 || wl->jobs[i].burst_time < 0) return SCHED_EINVAL;
+    }
+
+    if (worker_scratch_table(w, wl->count) != 0) return SCHED_ENOMEM;
+
+    proc_table_t *t = &w->table;
+    for (int i = 0; i < wl->count; i++) {
+        const sched_job_t *j = &wl->jobs[i];
+        t->pid[i] = j->pid;
+        t->arrival_time[i] = j->arrival_time;
+        t->burst_time[i] = j->burst_time;
+        t->remaining_time[i] = j->burst_time;
+        t->priority[i] = j->priority;
+        t->start_time[i] = 0;
+    }
+    return SCHED_OK;
+}
+
+static void fill_result(sched_result_t *r, const metrics_t *m) {
+    r->avg_turnaround_time = m->avg_turnaround_time;
+    r->avg_waiting_time = m->avg_waiting_time;
+    r->avg_response_time = m->avg_response_time;
+    r->cpu_utilization = m->cpu_utilization;
+    r->throughput = m->throughput;
+    r->fairness_index = m->fairness_index;
+    r->turnaround = (sched_percentiles_t){m->turnaround.p50, m->turnaround.p95, m->turnaround.p99,
+                                          m->turnaround.max};
+    r->waiting = (sched_percentiles_t){m->waiting.p50, m->waiting.p95, m->waiting.p99, m->waiting.max};
+    r->response = (sched_percentiles_t){m->response.p50, m->response.p95, m->response.p99,
+                                        m->response.max};
+}
+
+static void run_one(void *ctx, int worker, size_t task) {
+    batch_t *batch = ctx;
+    worker_scratch_t *w = &batch->workers[worker];
+    const sched_workload_t *wl = &batch->workloads[task / batch->config_count];
+    const sched_config_t *c = &batch->configs[task % batch->config_count];
+    sched_result_t *r = &batch->results[task];
+
+    memset(r, 0, sizeof(*r));
+    if (!config_valid(c)) {
+        r->status = SCHED_EINVAL;
+        return;
+    }
+    r->status = load_workload(w, wl);
+    if (r->status != SCHED_OK || wl->count == 0) return;
+
+    int quantums[MLFQ_MAX_QUEUES];
+    memcpy(quantums, c->mlfq_quantums, sizeof(int) * c->mlfq_levels);
+    mlfq_config_t mlfq = {c->mlfq_levels, quantums, c->mlfq_boost_interval};
+    cfs_config_t cfs = {c->cfs_latency, c->cfs_granularity};
+    sim_params_t params = {
+        .policy = (sim_policy_t)c->policy,
+        .quantum = c->quantum,
+        .mlfq = &mlfq,
+        .cfs = &cfs,
+        .seed = c->seed,
+        .aging_interval = c->aging_interval,
+    };
+
+    metrics_acc_t *acc = &w->acc;
+    metrics_acc_init(acc);
+
+    long events;
+    smp_stats_t stats = {0};
+    if (c->cpus > 1) {
+        smp_config_t smp = {c->cpus, (smp_balance_t)c->balance, c->balance_interval};
+        events = schedule_smp_table(&w->table, &params, &smp, &w->arena, &w->timeline, acc, &stats);
+    } else {
+        events = schedule_params_table(&params, &w->table, &w->arena, &w->timeline, acc);
+    }
+    if (events < 0) {
+        r->status = SCHED_ENOMEM;
+        return;
+    }
+
+    metrics_t m;
+    metrics_acc_finish(acc, 0, &m);
+    if (c->cpus > 1) m.cpu_utilization = stats.utilization;
+    fill_result(r, &m);
+    r->events = events;
+    r->makespan = acc->max_completion;
+    r->migrations = stats.migrations;
+}
+
+int sched_run_batch(const sched_workload_t *workloads, size_t workload_count,
+                    const sched_config_t *configs, size_t config_count,
+                    sched_result_t *results, int threads) {
+    if (workload_count == 0 || config_count == 0) return SCHED_OK;
+    if (!workloads || !configs || !results || workload_count > SIZE_MAX / config_count) {
+        return SCHED_EINVAL;
+    }
+
+    size_t tasks = workload_count * config_count;
+    int workers = threads > 0 ? threads : pool_default_workers();
+    if ((size_t)workers > tasks) workers = (int)tasks;
+
+    batch_t batch = {workloads, configs, config_count, results, calloc(workers, sizeof(worker_scratch_t))};
+    if (!batch.workers) return SCHED_ENOMEM;
+    for (int i = 0; i < workers; i++) worker_scratch_init(&batch.workers[i]);
+
+    int status = pool_run(workers, tasks, run_one, &batch) >= 0 ? SCHED_OK : SCHED_ENOMEM;
+
+    for (int i = 0; i < workers; i++) worker_scratch_free(&batch.workers[i]);
+    free(batch.workers);
+    return status;
+}
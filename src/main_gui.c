@@ -1,19 +1,32 @@
 #include <gtk/gtk.h>
 #include <stdlib.h>
 #include <string.h>
+#include <math.h>
+#include <limits.h>
 #include "scheduler.h"
+#include "gantt.h"
+#include "spsc.h"
+#include "workload.h"
+#include "process_model.h"
+#include "checkpoint.h"
+#include "trace.h"
 
 // --- Global State ---
 GtkWidget *window;
-GtkWidget *process_list_store;
+GtkWidget *process_view;
+ProcessModel *process_model;  // The workload; the table reads it in place
 GtkWidget *drawing_area;
 GtkWidget *combo_algorithm;
 GtkWidget *label_metrics; // New label to show text results
+GtkWidget *btn_run;
+GtkWidget *btn_cancel;
 
-process_t processes[MAX_PROCESSES];
-timeline_event_t timeline[1000]; // Max timeline size
-int num_processes = 0;
+timeline_t timeline;          // Filled by the selected algorithm
 int total_time = 0;
+gantt_view_t view;            // Visible part of the Gantt chart
+gantt_layout_t layout;        // Bars for the current view
+trace_t replay;               // Trace file shown instead of the timeline
+int replaying = 0;            // 'replay' is open
 
 // Color palette for processes (RGB)
 double colors[6][3] = {
@@ -25,176 +38,632 @@ double colors[6][3] = {
     {0.5, 0.2, 0.8}  // Purple
 };
 
-// --- Helper: Read Data from GUI Table ---
-void fetch_data_from_gui() {
-    GtkTreeIter iter;
-    gboolean valid = gtk_tree_model_get_iter_first(GTK_TREE_MODEL(process_list_store), &iter);
+// --- Gantt Chart Rendering ---
+#define CHART_MARGIN 10
+#define BAR_HEIGHT 40
 
-    num_processes = 0;
-    while (valid && num_processes < MAX_PROCESSES) {
-        int pid, arr, burst, prio;
-        gtk_tree_model_get(GTK_TREE_MODEL(process_list_store), &iter,
-                           0, &pid, 1, &arr, 2, &burst, 3, &prio, -1);
+static double chart_width(GtkWidget *widget) {
+    double w = gtk_widget_get_allocated_width(widget) - 2 * CHART_MARGIN;
+    return w > 1 ? w : 1;
+}
+
+static void set_bar_color(cairo_t *cr, int pid) {
+    if (pid == GANTT_MIXED) {
+        cairo_set_source_rgb(cr, 0.45, 0.45, 0.45);
+    } else {
+        int pid_idx = pid % 6; // Color cycling
+        cairo_set_source_rgb(cr, colors[pid_idx][0], colors[pid_idx][1], colors[pid_idx][2]);
+    }
+}
+
+// Paints the whole chart for the current view into 'cr'
+static void render_chart(cairo_t *cr, int width, int height) {
+    double plot_width = width - 2 * CHART_MARGIN;
+    int y_pos = (height / 2) - (BAR_HEIGHT / 2);
+
+    // Draw Background
+    cairo_set_source_rgb(cr, 0.95, 0.95, 0.95);
+    cairo_paint(cr);
+    if (total_time == 0 || plot_width <= 0) return;
+
+    // A trace is laid out straight from its mapping
+    int built = replaying ? gantt_layout_build_trace(&layout, &replay, &view, plot_width)
+                          : gantt_layout_build(&layout, &timeline, &view, plot_width);
+    if (built != 0) return;
+
+    // One fill per color: collect every bar of a color into a single path
+    for (int c = -1; c < 6; c++) {
+        int any = 0;
+        for (size_t i = 0; i < layout.count; i++) {
+            const gantt_bar_t *b = &layout.bars[i];
+            int color = b->pid == GANTT_MIXED ? -1 : b->pid % 6;
+            if (color != c) continue;
+            cairo_rectangle(cr, CHART_MARGIN + b->x, y_pos, b->width, BAR_HEIGHT);
+            any = 1;
+        }
+        if (any) {
+            set_bar_color(cr, c == -1 ? GANTT_MIXED : c);
+            cairo_fill(cr);
+        }
+    }
+
+    // Borders only where they don't swallow the bar
+    cairo_set_source_rgb(cr, 0, 0, 0);
+    cairo_set_line_width(cr, 1);
+    for (size_t i = 0; i < layout.count; i++) {
+        const gantt_bar_t *b = &layout.bars[i];
+        if (b->width >= 4) cairo_rectangle(cr, CHART_MARGIN + b->x, y_pos, b->width, BAR_HEIGHT);
+    }
+    cairo_stroke(cr);
+
+    // PID labels, only on bars wide enough to hold them
+    cairo_select_font_face(cr, "Sans", CAIRO_FONT_SLANT_NORMAL, CAIRO_FONT_WEIGHT_BOLD);
+    cairo_set_font_size(cr, 12);
+    cairo_set_source_rgb(cr, 1, 1, 1); // White text
+    for (size_t i = 0; i < layout.count; i++) {
+        const gantt_bar_t *b = &layout.bars[i];
+        if (b->pid == GANTT_MIXED || b->width < 20) continue;
+
+        char pid_str[16];
+        cairo_text_extents_t ext;
+        snprintf(pid_str, sizeof(pid_str), "P%d", b->pid);
+        cairo_text_extents(cr, pid_str, &ext);
+        if (ext.x_advance + 10 > b->width) continue;
+        cairo_move_to(cr, CHART_MARGIN + b->x + 5, y_pos + 25);
+        cairo_show_text(cr, pid_str);
+    }
 
-        processes[num_processes].pid = pid;
-        processes[num_processes].arrival_time = arr;
-        processes[num_processes].burst_time = burst;
-        processes[num_processes].priority = prio;
-        processes[num_processes].remaining_time = burst; // Reset
+    // Draw Ruler (Time markers)
+    cairo_set_source_rgb(cr, 0, 0, 0);
+    cairo_set_font_size(cr, 11);
+    double scale = plot_width / view.span;
+    long step = gantt_tick_step(&view, plot_width, 60);
+    long first = ((long)ceil(view.start) + step - 1) / step * step;
+    for (long t = first; t <= view.start + view.span; t += step) {
+        double x = CHART_MARGIN + (t - view.start) * scale;
+        cairo_move_to(cr, x, y_pos + BAR_HEIGHT + 5);
+        cairo_line_to(cr, x, y_pos + BAR_HEIGHT + 15);
+        cairo_stroke(cr);
 
-        num_processes++;
-        valid = gtk_tree_model_iter_next(GTK_TREE_MODEL(process_list_store), &iter);
+        char num[16];
+        snprintf(num, sizeof(num), "%ld", t);
+        cairo_move_to(cr, x - 5, y_pos + BAR_HEIGHT + 25);
+        cairo_show_text(cr, num);
     }
 }
 
-// --- Drawing Callback (The Gantt Chart) ---
-gboolean on_draw(GtkWidget *widget, cairo_t *cr, gpointer data) {
-    (void)data; (void)widget;
+// The rendered chart is cached and only repainted when the timeline, the
+// view or the widget size changes; other exposes just blit it
+static cairo_surface_t *chart_cache = NULL;
+static struct {
+    double start, span;
+    int width, height;
+    unsigned long generation;
+} cache_key;
+static unsigned long timeline_generation = 1;
 
-    if (total_time == 0) return FALSE;
+gboolean on_draw(GtkWidget *widget, cairo_t *cr, gpointer data) {
+    (void)data;
 
     int width = gtk_widget_get_allocated_width(widget);
     int height = gtk_widget_get_allocated_height(widget);
 
-    // Scale: How many pixels per time unit?
-    double scale = (double)(width - 20) / total_time;
-    int bar_height = 40;
-    int y_pos = (height / 2) - (bar_height / 2);
+    if (!chart_cache || cache_key.width != width || cache_key.height != height ||
+        cache_key.start != view.start || cache_key.span != view.span ||
+        cache_key.generation != timeline_generation) {
+        if (chart_cache) cairo_surface_destroy(chart_cache);
+        chart_cache = gdk_window_create_similar_surface(gtk_widget_get_window(widget),
+                                                        CAIRO_CONTENT_COLOR, width, height);
+        cairo_t *cache_cr = cairo_create(chart_cache);
+        render_chart(cache_cr, width, height);
+        cairo_destroy(cache_cr);
+
+        cache_key.start = view.start;
+        cache_key.span = view.span;
+        cache_key.width = width;
+        cache_key.height = height;
+        cache_key.generation = timeline_generation;
+    }
 
-    // Draw Background
-    cairo_set_source_rgb(cr, 0.95, 0.95, 0.95);
+    cairo_set_source_surface(cr, chart_cache, 0, 0);
     cairo_paint(cr);
+    return FALSE;
+}
 
-    // Draw Timeline Events
-    // Note: In a real app, we'd iterate the 'timeline' array.
-    // Since we cleared timeline in run_simulation, we rely on the algorithms filling it.
-    // For simplicity, we just redraw the whole timeline array we filled.
-
-    // Re-calculate how many events we have (simple scan)
-    int event_count = 0;
-    for(int i=0; i<1000; i++) {
-        if(timeline[i].duration == 0 && i > 0) break; // End of events
-        // Draw this block
-        int pid_idx = (timeline[i].pid) % 6; // Color cycling
-        cairo_set_source_rgb(cr, colors[pid_idx][0], colors[pid_idx][1], colors[pid_idx][2]);
+// --- Gantt Chart Zoom / Pan ---
+static double drag_x;
 
-        double x = 10 + (timeline[i].time * scale);
-        double w = timeline[i].duration * scale;
+// Scroll zooms around the pointer; Shift+scroll pans
+gboolean on_chart_scroll(GtkWidget *widget, GdkEventScroll *event, gpointer data) {
+    (void)data;
+    if (total_time == 0) return FALSE;
 
-        cairo_rectangle(cr, x, y_pos, w, bar_height);
-        cairo_fill(cr);
+    double width = chart_width(widget);
+    double direction = 0;
+    if (event->direction == GDK_SCROLL_UP) direction = 1;
+    else if (event->direction == GDK_SCROLL_DOWN) direction = -1;
+    else if (event->direction == GDK_SCROLL_SMOOTH) direction = -event->delta_y;
+    if (direction == 0) return FALSE;
+
+    if (event->state & GDK_SHIFT_MASK) {
+        gantt_view_pan(&view, -direction * view.span * 0.1, total_time);
+    } else {
+        double anchor = view.start + (event->x - CHART_MARGIN) / width * view.span;
+        gantt_view_zoom(&view, pow(1.25, direction), anchor, total_time);
+    }
+    gtk_widget_queue_draw(widget);
+    return TRUE;
+}
 
-        // Draw Border
-        cairo_set_source_rgb(cr, 0, 0, 0);
-        cairo_rectangle(cr, x, y_pos, w, bar_height);
-        cairo_stroke(cr);
+// Drag pans; double-click fits the whole run
+gboolean on_chart_button_press(GtkWidget *widget, GdkEventButton *event, gpointer data) {
+    (void)data;
+    if (event->button != 1) return FALSE;
 
-        // Draw PID text
-        char pid_str[10];
-        sprintf(pid_str, "P%d", timeline[i].pid);
-        cairo_select_font_face(cr, "Sans", CAIRO_FONT_SLANT_NORMAL, CAIRO_FONT_WEIGHT_BOLD);
-        cairo_set_font_size(cr, 12);
-        cairo_move_to(cr, x + 5, y_pos + 25);
-        cairo_set_source_rgb(cr, 1, 1, 1); // White text
-        cairo_show_text(cr, pid_str);
+    if (event->type == GDK_2BUTTON_PRESS) {
+        gantt_view_fit(&view, total_time);
+        gtk_widget_queue_draw(widget);
+    }
+    drag_x = event->x;
+    return TRUE;
+}
+
+gboolean on_chart_motion(GtkWidget *widget, GdkEventMotion *event, gpointer data) {
+    (void)data;
+    if (!(event->state & GDK_BUTTON1_MASK) || total_time == 0) return FALSE;
+
+    double dx = event->x - drag_x;
+    drag_x = event->x;
+    gantt_view_pan(&view, -dx / chart_width(widget) * view.span, total_time);
+    gtk_widget_queue_draw(widget);
+    return TRUE;
+}
 
-        event_count++;
+// --- Background Simulation ---
+// A run happens on a GTask worker thread with private copies of the workload,
+// timeline and accumulator. Finished timeline chunks reach the main loop
+// through a lock-free single-producer queue that a timer drains into the
+// displayed timeline, so the chart fills in as the run goes. The worker's
+// complete timeline replaces the displayed one in the completion callback,
+// which runs on the main thread, so on_draw never sees a half-written one.
+//
+// Every run records checkpoints (see checkpoint.h). The finished job is kept,
+// and if only one row's arrival or burst is edited before the next run with
+// the same algorithm, that run resumes from a checkpoint instead of t=0.
+#define SIM_QUEUE_CHUNKS 256
+#define SIM_POLL_MS 33
+
+typedef struct {
+    timeline_event_t *events;
+    size_t first;               // Timeline index of events[0]
+    size_t count;
+    long completed;             // Processes finished when the chunk was cut
+} sim_chunk_t;
+
+typedef struct {
+    int algo;
+    int resume_row;             // Edited row for an incremental run, or -1
+    int resumed_at;             // Simulation time the run resumed from
+    proc_table_t table;         // Private copy of the workload and its results
+    sim_session_t session;      // Checkpoints of the last run
+    timeline_t timeline;        // Written only by the worker
+    metrics_acc_t acc;
+    spsc_queue_t chunks;        // Worker -> main loop
+    GCancellable *cancellable;
+    guint poll_source;
+} sim_job_t;
+
+static sim_job_t *current_job = NULL;
+static sim_job_t *last_job = NULL;  // Finished run, kept for incremental re-runs
+static int edited_row = -1;         // Only row edited since then, -1 none, -2 more
+
+static void sim_job_free(sim_job_t *job) {
+    if (!job) return;
+    sim_chunk_t *chunk;
+    while ((chunk = spsc_pop(&job->chunks))) {
+        g_free(chunk->events);
+        g_free(chunk);
     }
+    spsc_free(&job->chunks);
+    timeline_free(&job->timeline);
+    sim_session_free(&job->session);
+    proc_table_free(&job->table);
+    if (job->cancellable) g_object_unref(job->cancellable);
+    g_free(job);
+}
 
-    // Draw Ruler (Time markers)
-    cairo_set_source_rgb(cr, 0, 0, 0);
-    for (int t = 0; t <= total_time; t += 5) {
-        double x = 10 + (t * scale);
-        cairo_move_to(cr, x, y_pos + bar_height + 5);
-        cairo_line_to(cr, x, y_pos + bar_height + 15);
-        cairo_stroke(cr);
+static sim_job_t *sim_job_new(int algo, const process_t *rows, int count) {
+    sim_job_t *job = g_new0(sim_job_t, 1);
+    if (spsc_init(&job->chunks, SIM_QUEUE_CHUNKS) != 0) {
+        g_free(job);
+        return NULL;
+    }
+    timeline_init(&job->timeline);
+    if (proc_table_from_array(&job->table, rows, count) != 0) {
+        sim_job_free(job);
+        return NULL;
+    }
 
-        char num[10];
-        sprintf(num, "%d", t);
-        cairo_set_source_rgb(cr, 0, 0, 0);
-        cairo_move_to(cr, x - 5, y_pos + bar_height + 25);
-        cairo_show_text(cr, num);
+    mlfq_config_t cfg = {3, (int[]){2,4,8}, 10}; // 3 Queues, Q=2,4,8, Boost=10
+    sim_params_t params = {(sim_policy_t)algo, 3, &cfg, NULL, 1, 10}; // Hardcoded Q=3 for demo, CFS defaults,
+                                                                       // lottery seed 1, priority aging every 10
+    sim_session_init(&job->session, &params);
+    job->algo = algo;
+    job->resume_row = -1;
+    return job;
+}
+
+// Worker side: copies the events that can no longer change into a chunk
+static int publish_chunk(void *ctx, const timeline_t *tl) {
+    sim_job_t *job = ctx;
+    if (g_cancellable_is_cancelled(job->cancellable)) return 1;
+
+    sim_chunk_t *chunk = g_new(sim_chunk_t, 1);
+    chunk->first = tl->published;
+    chunk->count = tl->count - 1 - tl->published;
+    chunk->events = g_new(timeline_event_t, chunk->count);
+    memcpy(chunk->events, &tl->events[tl->published], chunk->count * sizeof(timeline_event_t));
+    chunk->completed = (long)job->acc.count;
+
+    // Wait for the main loop to catch up rather than drop part of the chart
+    while (spsc_push(&job->chunks, chunk) != 0) {
+        if (g_cancellable_is_cancelled(job->cancellable)) {
+            g_free(chunk->events);
+            g_free(chunk);
+            return 1;
+        }
+        g_usleep(1000);
     }
+    return 0;
+}
 
-    return FALSE;
+static void sim_thread(GTask *task, gpointer source, gpointer task_data, GCancellable *cancellable) {
+    (void)source; (void)cancellable;
+    sim_job_t *job = task_data;
+    long events;
+
+    if (job->resume_row >= 0) {
+        events = sim_session_rerun(&job->session, &job->table, job->resume_row, &job->timeline,
+                                   &job->acc, &job->resumed_at);
+    } else {
+        metrics_acc_init(&job->acc);
+        events = sim_session_run(&job->session, &job->table, &job->timeline, &job->acc);
+    }
+
+    g_task_return_int(task, events);
 }
 
-// --- Button: Run Simulation ---
-void on_run_clicked(GtkWidget *widget, gpointer data) {
-    (void)widget; (void)data;
-    fetch_data_from_gui();
+// Moves the end of the chart to 'end'. A view showing the whole run keeps
+// doing so; one the user has zoomed or panned is only clamped.
+static void follow_run(int end) {
+    int whole = total_time <= 0 || (view.start <= 0 && view.start + view.span >= total_time);
+    total_time = end;
+    if (whole) gantt_view_fit(&view, total_time);
+    else gantt_view_clamp(&view, total_time);
+}
 
-    // Clear timeline
-    memset(timeline, 0, sizeof(timeline));
+// Main loop side: splices published chunks into the displayed timeline. A
+// resumed run starts part-way through, replacing the old run's tail.
+static gboolean drain_chunks(gpointer data) {
+    sim_job_t *job = data;
+    sim_chunk_t *chunk;
+    long completed = -1;
+
+    while ((chunk = spsc_pop(&job->chunks))) {
+        if (chunk->first < timeline.count) timeline.count = chunk->first;
+        for (size_t i = 0; i < chunk->count; i++) {
+            const timeline_event_t *e = &chunk->events[i];
+            timeline_append(&timeline, e->time, e->pid, e->duration);
+        }
+        completed = chunk->completed;
+        g_free(chunk->events);
+        g_free(chunk);
+    }
 
-    // Get Selected Algorithm
-    int algo_idx = gtk_combo_box_get_active(GTK_COMBO_BOX(combo_algorithm));
+    if (completed >= 0 && timeline.count > 0) {
+        const timeline_event_t *last = &timeline.events[timeline.count - 1];
+        follow_run(last->time + last->duration);
+        timeline_generation++;
+        gtk_widget_queue_draw(drawing_area);
 
-    // Run the Algorithm
-    if (algo_idx == 0) schedule_fifo(processes, num_processes, timeline);
-    else if (algo_idx == 1) schedule_sjf(processes, num_processes, timeline);
-    else if (algo_idx == 2) schedule_stcf(processes, num_processes, timeline);
-    else if (algo_idx == 3) schedule_rr(processes, num_processes, 3, timeline); // Hardcoded Q=3 for demo
-    else if (algo_idx == 4) {
-        mlfq_config_t cfg = {3, (int[]){2,4,8}, 10}; // 3 Queues, Q=2,4,8, Boost=10
-        schedule_mlfq(processes, num_processes, &cfg, timeline);
+        char progress[64];
+        snprintf(progress, sizeof(progress), "Running... %ld of %d processes finished",
+                 completed, job->table.n);
+        gtk_label_set_text(GTK_LABEL(label_metrics), progress);
     }
+    return G_SOURCE_CONTINUE;
+}
 
-    // Find max time for scaling
-    total_time = 0;
-    for(int i=0; i<num_processes; i++) {
-        if(processes[i].completion_time > total_time) total_time = processes[i].completion_time;
+static void on_sim_done(GObject *source, GAsyncResult *result, gpointer data) {
+    (void)source; (void)data;
+    sim_job_t *job = g_task_get_task_data(G_TASK(result));
+    long events = g_task_propagate_int(G_TASK(result), NULL);
+
+    g_source_remove(job->poll_source);
+    current_job = NULL;
+    gtk_widget_set_sensitive(btn_run, TRUE);
+    gtk_widget_set_sensitive(btn_cancel, FALSE);
+
+    if (g_cancellable_is_cancelled(job->cancellable)) {
+        // Keep whatever part of the chart was already streamed in
+        sim_job_free(job);
+        gtk_label_set_text(GTK_LABEL(label_metrics), "Simulation cancelled");
+        return;
+    }
+    if (events < 0) {
+        sim_job_free(job);
+        timeline_clear(&timeline);
+        total_time = 0;
+        timeline_generation++;
+        gtk_label_set_text(GTK_LABEL(label_metrics), "Simulation failed: out of memory");
+        gtk_widget_queue_draw(drawing_area);
+        return;
     }
 
-    // Calculate Metrics
+    // Swap in the finished timeline; the streamed preview is dropped
+    timeline_free(&timeline);
+    timeline = job->timeline;
+    timeline_observe(&timeline, NULL, NULL);
+    timeline_init(&job->timeline);
+
+    // Finish Metrics (accumulated during the run)
+    follow_run(job->acc.max_completion);
     metrics_t m;
-    calculate_metrics(processes, num_processes, total_time, &m);
+    metrics_acc_finish(&job->acc, total_time, &m);
 
     // Update Label
+    char resumed[64] = "";
+    if (job->resume_row >= 0 && job->resumed_at > 0) {
+        snprintf(resumed, sizeof(resumed), " (re-simulated from t=%d)", job->resumed_at);
+    }
     char result_txt[512];
-    sprintf(result_txt,
-        "<b>Metrics Result:</b>\n"
+    snprintf(result_txt, sizeof(result_txt),
+        "<b>Metrics Result:</b>%s\n"
         "Avg Turnaround: %.2f | Avg Waiting: %.2f\n"
-        "Avg Response: %.2f | CPU Util: %.1f%%",
+        "Avg Response: %.2f | CPU Util: %.1f%%\n"
+        "Turnaround p95/p99: %.0f/%.0f | Response p95/p99: %.0f/%.0f",
+        resumed,
         m.avg_turnaround_time, m.avg_waiting_time,
-        m.avg_response_time, m.cpu_utilization);
+        m.avg_response_time, m.cpu_utilization,
+        m.turnaround.p95, m.turnaround.p99, m.response.p95, m.response.p99);
     gtk_label_set_markup(GTK_LABEL(label_metrics), result_txt);
 
     // Redraw Gantt Chart
+    timeline_generation++;
     gtk_widget_queue_draw(drawing_area);
+
+    // Keep the run's table and checkpoints for the next edit
+    g_clear_object(&job->cancellable);
+    last_job = job;
+}
+
+// Reuses the last run when exactly one row's arrival or burst changed since
+static sim_job_t *incremental_job(int algo, const process_t *rows, int count) {
+    sim_job_t *job = last_job;
+    if (!job || job->algo != algo || job->table.n != count || edited_row < 0) return NULL;
+
+    // The worker resumes on top of the previous timeline
+    if (timeline_reserve(&job->timeline, timeline.count) != 0) return NULL;
+    memcpy(job->timeline.events, timeline.events, sizeof(timeline_event_t) * timeline.count);
+    job->timeline.count = timeline.count;
+
+    job->resume_row = edited_row;
+    job->table.arrival_time[edited_row] = rows[edited_row].arrival_time;
+    job->table.burst_time[edited_row] = rows[edited_row].burst_time;
+    last_job = NULL;
+    return job;
+}
+
+// --- Button: Run Simulation ---
+void on_run_clicked(GtkWidget *widget, gpointer data) {
+    (void)widget; (void)data;
+    if (current_job) return;
+
+    // Get Selected Algorithm
+    int algo = gtk_combo_box_get_active(GTK_COMBO_BOX(combo_algorithm));
+
+    // Back to the simulator's own timeline
+    if (replaying) {
+        trace_close(&replay);
+        replaying = 0;
+        total_time = 0;
+        if (timeline.count > 0) {
+            const timeline_event_t *last = &timeline.events[timeline.count - 1];
+            total_time = last->time + last->duration;
+        }
+        gantt_view_fit(&view, total_time);
+        timeline_generation++;
+    }
+
+    // Edits made while the run is going must not reach the worker
+    int count;
+    const process_t *rows = process_model_rows(process_model, &count);
+    sim_job_t *job = incremental_job(algo, rows, count);
+    if (!job) {
+        sim_job_free(last_job);
+        last_job = NULL;
+        job = sim_job_new(algo, rows, count);
+    }
+    edited_row = -1;
+    if (!job) {
+        gtk_label_set_text(GTK_LABEL(label_metrics), "Simulation failed: out of memory");
+        return;
+    }
+    job->cancellable = g_cancellable_new();
+    timeline_observe(&job->timeline, publish_chunk, job);
+
+    // A full run starts from an empty chart that fills in as chunks arrive;
+    // a resumed one keeps the old chart until its chunks replace the tail
+    if (job->resume_row < 0) {
+        timeline_clear(&timeline);
+        total_time = 0;
+        timeline_generation++;
+        gtk_widget_queue_draw(drawing_area);
+    }
+    gtk_label_set_text(GTK_LABEL(label_metrics), "Running...");
+    gtk_widget_set_sensitive(btn_run, FALSE);
+    gtk_widget_set_sensitive(btn_cancel, TRUE);
+
+    current_job = job;
+    job->poll_source = g_timeout_add(SIM_POLL_MS, drain_chunks, job);
+
+    GTask *task = g_task_new(NULL, job->cancellable, on_sim_done, NULL);
+    g_task_set_task_data(task, job, NULL);
+    g_task_run_in_thread(task, sim_thread);
+    g_object_unref(task);
+}
+
+// --- Button: Cancel Simulation ---
+// The worker notices at its next timeline chunk and stops
+void on_cancel_clicked(GtkWidget *widget, gpointer data) {
+    (void)widget; (void)data;
+    if (current_job) g_cancellable_cancel(current_job->cancellable);
+}
+
+// --- Process Table ---
+static void add_process(int pid, int arrival, int burst, int priority) {
+    process_t p = {0};
+    p.pid = pid;
+    p.arrival_time = arrival;
+    p.burst_time = p.remaining_time = burst;
+    p.priority = priority;
+    edited_row = -2;
+    if (process_model_append(process_model, &p) != 0) {
+        gtk_label_set_text(GTK_LABEL(label_metrics), "Could not add process: out of memory");
+    }
 }
 
-// --- Boilerplate Setup ---
 void on_add_process_clicked(GtkWidget *widget, gpointer data) {
     (void)widget; (void)data;
-    GtkListStore *store = GTK_LIST_STORE(process_list_store);
-    GtkTreeIter iter;
-    gtk_list_store_append(store, &iter);
-    gtk_list_store_set(store, &iter, 0, num_processes+1, 1, 0, 2, 5, 3, 1, -1);
+    int count;
+    process_model_rows(process_model, &count);
+    add_process(count + 1, 0, 5, 1);
 }
 
 void load_default_data() {
-    GtkListStore *store = GTK_LIST_STORE(process_list_store);
-    GtkTreeIter iter;
-    gtk_list_store_append(store, &iter); gtk_list_store_set(store, &iter, 0, 1, 1, 0, 2, 5, 3, 1, -1);
-    gtk_list_store_append(store, &iter); gtk_list_store_set(store, &iter, 0, 2, 1, 1, 2, 3, 3, 2, -1);
-    gtk_list_store_append(store, &iter); gtk_list_store_set(store, &iter, 0, 3, 1, 2, 2, 8, 3, 1, -1);
+    add_process(1, 0, 5, 1);
+    add_process(2, 1, 3, 2);
+    add_process(3, 2, 8, 1);
+}
+
+// Writes an edited cell straight back to the process array
+static void on_cell_edited(GtkCellRendererText *renderer, gchar *path, gchar *text, gpointer data) {
+    (void)renderer;
+    int column = GPOINTER_TO_INT(data);
+    char *end;
+    long value = strtol(text, &end, 10);
+
+    // Times cannot be negative, as in the workload loader. Priority can: CFS
+    // reads it as a nice value.
+    if (end == text || *end != '\0' || value < INT_MIN || value > INT_MAX) return;
+    if (value < 0 && column != PROCESS_COLUMN_PRIORITY) return;
+
+    int row = atoi(path);
+    process_model_set(process_model, row, column, (int)value);
+
+    // Arrival and burst edits of a single row can be re-simulated incrementally
+    int incremental = column == PROCESS_COLUMN_ARRIVAL || column == PROCESS_COLUMN_BURST;
+    if (incremental && (edited_row == -1 || edited_row == row)) edited_row = row;
+    else edited_row = -2;
+}
+
+// Bulk load: the view is detached while the array is swapped, so a million
+// rows cost one model switch instead of a million row-inserted signals
+void on_load_clicked(GtkWidget *widget, gpointer data) {
+    (void)widget; (void)data;
+    GtkWidget *dialog = gtk_file_chooser_dialog_new("Load Workload", GTK_WINDOW(window),
+                                                    GTK_FILE_CHOOSER_ACTION_OPEN,
+                                                    "_Cancel", GTK_RESPONSE_CANCEL,
+                                                    "_Open", GTK_RESPONSE_ACCEPT, NULL);
+    if (gtk_dialog_run(GTK_DIALOG(dialog)) == GTK_RESPONSE_ACCEPT) {
+        char *path = gtk_file_chooser_get_filename(GTK_FILE_CHOOSER(dialog));
+        process_t *rows;
+        int count = workload_load(path, &rows);
+        if (count < 0) {
+            gtk_label_set_text(GTK_LABEL(label_metrics), "Could not load workload (see terminal)");
+        } else {
+            gtk_tree_view_set_model(GTK_TREE_VIEW(process_view), NULL);
+            process_model_replace(process_model, rows, count);
+            edited_row = -2;
+            gtk_tree_view_set_model(GTK_TREE_VIEW(process_view), GTK_TREE_MODEL(process_model));
+
+            char msg[64];
+            snprintf(msg, sizeof(msg), "Loaded %d processes", count);
+            gtk_label_set_text(GTK_LABEL(label_metrics), msg);
+        }
+        g_free(path);
+    }
+    gtk_widget_destroy(dialog);
+}
+
+// --- Button: Open Trace ---
+// Shows a trace written by scheduler_cli --trace. The file stays mapped and
+// the chart decodes only the events in view, however long the run was.
+void on_open_trace_clicked(GtkWidget *widget, gpointer data) {
+    (void)widget; (void)data;
+    if (current_job) return;
+
+    GtkWidget *dialog = gtk_file_chooser_dialog_new("Open Trace", GTK_WINDOW(window),
+                                                    GTK_FILE_CHOOSER_ACTION_OPEN,
+                                                    "_Cancel", GTK_RESPONSE_CANCEL,
+                                                    "_Open", GTK_RESPONSE_ACCEPT, NULL);
+    if (gtk_dialog_run(GTK_DIALOG(dialog)) == GTK_RESPONSE_ACCEPT) {
+        char *path = gtk_file_chooser_get_filename(GTK_FILE_CHOOSER(dialog));
+        trace_t opened;
+        if (trace_open(path, &opened) != 0) {
+            gtk_label_set_text(GTK_LABEL(label_metrics), "Could not open trace (see terminal)");
+        } else if (opened.cpus > 1) {
+            // One row cannot show overlapping cores
+            trace_close(&opened);
+            gtk_label_set_text(GTK_LABEL(label_metrics),
+                               "Multi-core trace: list it with scheduler_cli --replay FILE --window START:END");
+        } else {
+            if (replaying) trace_close(&replay);
+            replay = opened;
+            replaying = 1;
+            total_time = replay.end_time;
+            gantt_view_fit(&view, total_time);
+            timeline_generation++;
+            gtk_widget_queue_draw(drawing_area);
+
+            char msg[128];
+            snprintf(msg, sizeof(msg), "Trace: %zu events over %d time units (Run to go back)",
+                     replay.count, replay.end_time);
+            gtk_label_set_text(GTK_LABEL(label_metrics), msg);
+        }
+        g_free(path);
+    }
+    gtk_widget_destroy(dialog);
 }
 
 GtkWidget* create_process_view() {
-    process_list_store = (GtkWidget*)gtk_list_store_new(4, G_TYPE_INT, G_TYPE_INT, G_TYPE_INT, G_TYPE_INT);
-    GtkWidget *view = gtk_tree_view_new_with_model(GTK_TREE_MODEL(process_list_store));
-    GtkCellRenderer *renderer = gtk_cell_renderer_text_new();
-    g_object_set(renderer, "editable", TRUE, NULL); // Note: editing needs a callback to actually save changes
-    gtk_tree_view_insert_column_with_attributes(GTK_TREE_VIEW(view), -1, "PID", renderer, "text", 0, NULL);
-    gtk_tree_view_insert_column_with_attributes(GTK_TREE_VIEW(view), -1, "Arrival", renderer, "text", 1, NULL);
-    gtk_tree_view_insert_column_with_attributes(GTK_TREE_VIEW(view), -1, "Burst", renderer, "text", 2, NULL);
-    gtk_tree_view_insert_column_with_attributes(GTK_TREE_VIEW(view), -1, "Priority", renderer, "text", 3, NULL);
-    return view;
+    static const char *titles[PROCESS_MODEL_N_COLUMNS] = {"PID", "Arrival", "Burst", "Priority"};
+
+    process_model = process_model_new();
+    process_view = gtk_tree_view_new_with_model(GTK_TREE_MODEL(process_model));
+
+    // Fixed-height rows let the view skip measuring, so it only ever reads
+    // the rows that are on screen
+    for (int c = 0; c < PROCESS_MODEL_N_COLUMNS; c++) {
+        GtkCellRenderer *renderer = gtk_cell_renderer_text_new();
+        g_object_set(renderer, "editable", TRUE, NULL);
+        g_signal_connect(renderer, "edited", G_CALLBACK(on_cell_edited), GINT_TO_POINTER(c));
+
+        GtkTreeViewColumn *column =
+            gtk_tree_view_column_new_with_attributes(titles[c], renderer, "text", c, NULL);
+        gtk_tree_view_column_set_sizing(column, GTK_TREE_VIEW_COLUMN_FIXED);
+        gtk_tree_view_column_set_fixed_width(column, 100);
+        gtk_tree_view_append_column(GTK_TREE_VIEW(process_view), column);
+    }
+    gtk_tree_view_set_fixed_height_mode(GTK_TREE_VIEW(process_view), TRUE);
+    return process_view;
 }
 
 int main(int argc, char *argv[]) {
     gtk_init(&argc, &argv);
+    timeline_init(&timeline);
+    gantt_layout_init(&layout);
+    gantt_view_fit(&view, 0);
 
     window = gtk_window_new(GTK_WINDOW_TOPLEVEL);
     gtk_window_set_title(GTK_WINDOW(window), "CPU Scheduler Simulator");
@@ -215,17 +684,35 @@ int main(int argc, char *argv[]) {
     gtk_combo_box_text_append_text(GTK_COMBO_BOX_TEXT(combo_algorithm), "STCF");
     gtk_combo_box_text_append_text(GTK_COMBO_BOX_TEXT(combo_algorithm), "Round Robin");
     gtk_combo_box_text_append_text(GTK_COMBO_BOX_TEXT(combo_algorithm), "MLFQ");
+    gtk_combo_box_text_append_text(GTK_COMBO_BOX_TEXT(combo_algorithm), "CFS");
+    gtk_combo_box_text_append_text(GTK_COMBO_BOX_TEXT(combo_algorithm), "Lottery");
+    gtk_combo_box_text_append_text(GTK_COMBO_BOX_TEXT(combo_algorithm), "Stride");
+    gtk_combo_box_text_append_text(GTK_COMBO_BOX_TEXT(combo_algorithm), "Priority");
+    gtk_combo_box_text_append_text(GTK_COMBO_BOX_TEXT(combo_algorithm), "Priority (Preemptive)");
     gtk_combo_box_set_active(GTK_COMBO_BOX(combo_algorithm), 0);
     gtk_box_pack_start(GTK_BOX(hbox_top), combo_algorithm, FALSE, FALSE, 0);
 
-    GtkWidget *btn_run = gtk_button_new_with_label("Run Simulation");
+    btn_run = gtk_button_new_with_label("Run Simulation");
     g_signal_connect(btn_run, "clicked", G_CALLBACK(on_run_clicked), NULL);
     gtk_box_pack_start(GTK_BOX(hbox_top), btn_run, FALSE, FALSE, 0);
 
+    btn_cancel = gtk_button_new_with_label("Cancel");
+    gtk_widget_set_sensitive(btn_cancel, FALSE);
+    g_signal_connect(btn_cancel, "clicked", G_CALLBACK(on_cancel_clicked), NULL);
+    gtk_box_pack_start(GTK_BOX(hbox_top), btn_cancel, FALSE, FALSE, 0);
+
     GtkWidget *btn_add = gtk_button_new_with_label("Add Process");
     g_signal_connect(btn_add, "clicked", G_CALLBACK(on_add_process_clicked), NULL);
     gtk_box_pack_start(GTK_BOX(hbox_top), btn_add, FALSE, FALSE, 0);
 
+    GtkWidget *btn_load = gtk_button_new_with_label("Load Workload");
+    g_signal_connect(btn_load, "clicked", G_CALLBACK(on_load_clicked), NULL);
+    gtk_box_pack_start(GTK_BOX(hbox_top), btn_load, FALSE, FALSE, 0);
+
+    GtkWidget *btn_trace = gtk_button_new_with_label("Open Trace");
+    g_signal_connect(btn_trace, "clicked", G_CALLBACK(on_open_trace_clicked), NULL);
+    gtk_box_pack_start(GTK_BOX(hbox_top), btn_trace, FALSE, FALSE, 0);
+
     // Middle: Table
     GtkWidget *scroll_win = gtk_scrolled_window_new(NULL, NULL);
     gtk_widget_set_size_request(scroll_win, -1, 200);
@@ -234,17 +721,31 @@ int main(int argc, char *argv[]) {
     load_default_data();
 
     // Metrics Label
-    label_metrics = gtk_label_new("Click Run to see metrics");
+    label_metrics = gtk_label_new("Click Run to see metrics (scroll the chart to zoom, drag to pan, double-click to fit)");
     gtk_box_pack_start(GTK_BOX(vbox_main), label_metrics, FALSE, FALSE, 0);
 
     // Bottom: Gantt Chart
     drawing_area = gtk_drawing_area_new();
     gtk_widget_set_size_request(drawing_area, 800, 300);
+    gtk_widget_add_events(drawing_area, GDK_SCROLL_MASK | GDK_SMOOTH_SCROLL_MASK |
+                          GDK_BUTTON_PRESS_MASK | GDK_BUTTON1_MOTION_MASK);
     g_signal_connect(G_OBJECT(drawing_area), "draw", G_CALLBACK(on_draw), NULL);
+    g_signal_connect(G_OBJECT(drawing_area), "scroll-event", G_CALLBACK(on_chart_scroll), NULL);
+    g_signal_connect(G_OBJECT(drawing_area), "button-press-event", G_CALLBACK(on_chart_button_press), NULL);
+    g_signal_connect(G_OBJECT(drawing_area), "motion-notify-event", G_CALLBACK(on_chart_motion), NULL);
     gtk_box_pack_start(GTK_BOX(vbox_main), drawing_area, TRUE, TRUE, 0);
 
     gtk_widget_show_all(window);
     gtk_main();
 
+    // Let a running worker stop at its next chunk; process exit reclaims it
+    if (current_job) g_cancellable_cancel(current_job->cancellable);
+
+    if (!current_job) sim_job_free(last_job);
+    if (chart_cache) cairo_surface_destroy(chart_cache);
+    gantt_layout_free(&layout);
+    if (replaying) trace_close(&replay);
+    timeline_free(&timeline);
+    g_object_unref(process_model);
     return 0;
 }
\ No newline at end of file
@@ -1,41 +1,253 @@
+#include <string.h>
 #include "scheduler.h"
 
-void calculate_metrics(process_t *processes, int n, int total_time, metrics_t *metrics) {
-    double total_turnaround = 0;
-    double total_waiting = 0;
-    double total_response = 0;
-    double total_burst = 0;
-    double sum_sq_turnaround = 0; // For fairness calculation
+// ------------------------------------------------------
+// Log-bucketed histogram
+// ------------------------------------------------------
 
-    for (int i = 0; i < n; i++) {
-        total_turnaround += processes[i].turnaround_time;
-        total_waiting += processes[i].waiting_time;
-        total_response += processes[i].response_time;
-        total_burst += processes[i].burst_time;
+static int hist_bucket(int value) {
+    if (value < HIST_EXACT) return value < 0 ? 0 : value;
+
+    // Position of the highest set bit picks the octave, the next 5 bits the
+    // sub-bucket inside it
+    int msb = 31 - __builtin_clz((unsigned)value);
+    int shift = msb - 5;
+    int sub = (value >> shift) - HIST_SUB_BUCKETS;
+    return HIST_EXACT + (msb - 6) * HIST_SUB_BUCKETS + sub;
+}
+
+// Smallest value that falls into 'bucket', and the bucket's width
+static void hist_bucket_range(int bucket, double *low, double *width) {
+    if (bucket < HIST_EXACT) {
+        *low = bucket;
+        *width = 1;
+        return;
+    }
+    int octave = (bucket - HIST_EXACT) / HIST_SUB_BUCKETS;
+    int sub = (bucket - HIST_EXACT) % HIST_SUB_BUCKETS;
+    int shift = octave + 1;
+    *low = (double)(HIST_SUB_BUCKETS + sub) * (double)(1 << shift);
+    *width = (double)(1 << shift);
+}
+
+void histogram_add(histogram_t *h, int value) {
+    h->counts[hist_bucket(value)]++;
+    if (value > h->max) h->max = value;
+}
+
+// Nearest-rank percentile, reported as the middle of its bucket
+double histogram_percentile(const histogram_t *h, uint64_t total, double q) {
+    if (total == 0) return 0;
+
+    uint64_t rank = (uint64_t)(q * total);
+    if (rank < q * total || rank == 0) rank++;
+
+    uint64_t seen = 0;
+    for (int b = 0; b < HIST_BUCKETS; b++) {
+        seen += h->counts[b];
+        if (seen >= rank) {
+            double low, width;
+            hist_bucket_range(b, &low, &width);
+            double value = width == 1 ? low : low + width / 2;
+            return value > h->max ? h->max : value;
+        }
+    }
+    return h->max;
+}
+
+static void hist_summary(const histogram_t *h, uint64_t total, percentiles_t *out) {
+    out->p50 = histogram_percentile(h, total, 0.50);
+    out->p95 = histogram_percentile(h, total, 0.95);
+    out->p99 = histogram_percentile(h, total, 0.99);
+    out->max = total ? h->max : 0;
+}
+
+// ------------------------------------------------------
+// Streaming accumulator
+// ------------------------------------------------------
+
+void metrics_acc_init(metrics_acc_t *acc) {
+    memset(acc, 0, sizeof(*acc));
+}
+
+// Neumaier's variant of Kahan summation: also exact when the addend is the
+// larger of the two
+static void compensated_add(double *sum, double *compensation, double value) {
+    double t = *sum + value;
+    if ((*sum >= 0 ? *sum : -*sum) >= (value >= 0 ? value : -value)) {
+        *compensation += (*sum - t) + value;
+    } else {
+        *compensation += (value - t) + *sum;
+    }
+    *sum = t;
+}
+
+void metrics_acc_add_times(metrics_acc_t *acc, int burst, int completion, int turnaround,
+                           int waiting, int response) {
+    acc->count++;
+    acc->total_turnaround += turnaround;
+    acc->total_waiting += waiting;
+    acc->total_response += response;
+    acc->total_burst += burst;
+
+    // Square in double: the int product overflows for turnarounds above ~46k
+    double tat = turnaround;
+    compensated_add(&acc->sum_sq_turnaround, &acc->sum_sq_compensation, tat * tat);
+
+    if (completion > acc->max_completion) acc->max_completion = completion;
 
-        // Sum of squares for Jain's Fairness Index
-        sum_sq_turnaround += (processes[i].turnaround_time * processes[i].turnaround_time);
+    histogram_add(&acc->turnaround, turnaround);
+    histogram_add(&acc->waiting, waiting);
+    histogram_add(&acc->response, response);
+}
+
+void metrics_acc_add(metrics_acc_t *acc, const process_t *p) {
+    metrics_acc_add_times(acc, p->burst_time, p->completion_time, p->turnaround_time,
+                          p->waiting_time, p->response_time);
+}
+
+void metrics_acc_merge(metrics_acc_t *into, const metrics_acc_t *from) {
+    into->count += from->count;
+    into->total_turnaround += from->total_turnaround;
+    into->total_waiting += from->total_waiting;
+    into->total_response += from->total_response;
+    into->total_burst += from->total_burst;
+    compensated_add(&into->sum_sq_turnaround, &into->sum_sq_compensation, from->sum_sq_turnaround);
+    into->sum_sq_compensation += from->sum_sq_compensation;
+    if (from->max_completion > into->max_completion) into->max_completion = from->max_completion;
+
+    const histogram_t *src[3] = {&from->turnaround, &from->waiting, &from->response};
+    histogram_t *dst[3] = {&into->turnaround, &into->waiting, &into->response};
+    for (int k = 0; k < 3; k++) {
+        for (int b = 0; b < HIST_BUCKETS; b++) dst[k]->counts[b] += src[k]->counts[b];
+        if (src[k]->max > dst[k]->max) dst[k]->max = src[k]->max;
     }
+}
+
+void metrics_acc_finish(const metrics_acc_t *acc, int total_time, metrics_t *metrics) {
+    double n = (double)acc->count;
+
+    memset(metrics, 0, sizeof(*metrics));
+    if (acc->count == 0) return;
+    if (total_time <= 0) total_time = acc->max_completion;
 
     // Averages
-    metrics->avg_turnaround_time = total_turnaround / n;
-    metrics->avg_waiting_time = total_waiting / n;
-    metrics->avg_response_time = total_response / n;
+    metrics->avg_turnaround_time = acc->total_turnaround / n;
+    metrics->avg_waiting_time = acc->total_waiting / n;
+    metrics->avg_response_time = acc->total_response / n;
 
     // CPU Utilization = (Busy Time / Total Simulation Time) * 100
     if (total_time > 0) {
-        metrics->cpu_utilization = (total_burst / total_time) * 100.0;
-        metrics->throughput = (double)n / total_time;
-    } else {
-        metrics->cpu_utilization = 0;
-        metrics->throughput = 0;
+        metrics->cpu_utilization = ((double)acc->total_burst / total_time) * 100.0;
+        metrics->throughput = n / total_time;
     }
 
     // Jain's Fairness Index = (Sum(x))^2 / (n * Sum(x^2))
     // We use Turnaround Time as the metric 'x' for fairness
-    if (sum_sq_turnaround > 0) {
-        metrics->fairness_index = (total_turnaround * total_turnaround) / (n * sum_sq_turnaround);
-    } else {
-        metrics->fairness_index = 0;
+    double sum_sq = acc->sum_sq_turnaround + acc->sum_sq_compensation;
+    if (sum_sq > 0) {
+        double total = (double)acc->total_turnaround;
+        metrics->fairness_index = (total * total) / (n * sum_sq);
+    }
+
+    // Tails
+    hist_summary(&acc->turnaround, acc->count, &metrics->turnaround);
+    hist_summary(&acc->waiting, acc->count, &metrics->waiting);
+    hist_summary(&acc->response, acc->count, &metrics->response);
+}
+
+void calculate_metrics(process_t *processes, int n, int total_time, metrics_t *metrics) {
+    metrics_acc_t acc;
+    metrics_acc_init(&acc);
+
+    for (int i = 0; i < n; i++) {
+        metrics_acc_add(&acc, &processes[i]);
+    }
+
+    metrics_acc_finish(&acc, total_time, metrics);
+
+    // An explicit zero-length run has no utilization to report
+    if (total_time <= 0) {
+        metrics->cpu_utilization = 0;
+        metrics->throughput = 0;
+    }
+}
+
+// ------------------------------------------------------
+// Column reductions over a process table
+// ------------------------------------------------------
+
+// GCC vector extensions: four int lanes, widened to int64 / double lanes
+// before accumulating so the sums cannot overflow
+typedef int v4si __attribute__((vector_size(16)));
+typedef long long v4di __attribute__((vector_size(32)));
+typedef double v4df __attribute__((vector_size(32)));
+
+static inline v4si load_v4si(const int *p) {
+    v4si v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+void calculate_metrics_table(const proc_table_t *t, int total_time, metrics_t *metrics) {
+    metrics_acc_t acc;
+    metrics_acc_init(&acc);
+
+    int n = t->n;
+    int i = 0;
+    v4di tat_sum = {0}, wait_sum = {0}, resp_sum = {0}, burst_sum = {0};
+    v4df sq_sum = {0}, sq_comp = {0};
+    v4si max_completion = {0};
+
+    for (; i + 4 <= n; i += 4) {
+        v4si tat = load_v4si(&t->turnaround_time[i]);
+        v4si completion = load_v4si(&t->completion_time[i]);
+
+        tat_sum += __builtin_convertvector(tat, v4di);
+        wait_sum += __builtin_convertvector(load_v4si(&t->waiting_time[i]), v4di);
+        resp_sum += __builtin_convertvector(load_v4si(&t->response_time[i]), v4di);
+        burst_sum += __builtin_convertvector(load_v4si(&t->burst_time[i]), v4di);
+
+        // Lane-wise Kahan summation of the squared turnarounds
+        v4df x = __builtin_convertvector(tat, v4df);
+        v4df y = x * x - sq_comp;
+        v4df sum = sq_sum + y;
+        sq_comp = (sum - sq_sum) - y;
+        sq_sum = sum;
+
+        // Comparisons yield all-ones lanes where true, so this is a lane-wise max
+        v4si greater = completion > max_completion;
+        max_completion = (completion & greater) | (max_completion & ~greater);
+    }
+
+    for (int lane = 0; lane < 4; lane++) {
+        acc.total_turnaround += tat_sum[lane];
+        acc.total_waiting += wait_sum[lane];
+        acc.total_response += resp_sum[lane];
+        acc.total_burst += burst_sum[lane];
+        compensated_add(&acc.sum_sq_turnaround, &acc.sum_sq_compensation, sq_sum[lane]);
+        acc.sum_sq_compensation -= sq_comp[lane];
+        if (max_completion[lane] > acc.max_completion) acc.max_completion = max_completion[lane];
+    }
+    acc.count = i;
+
+    // Histograms are scattered increments and stay scalar
+    for (int j = 0; j < i; j++) {
+        histogram_add(&acc.turnaround, t->turnaround_time[j]);
+        histogram_add(&acc.waiting, t->waiting_time[j]);
+        histogram_add(&acc.response, t->response_time[j]);
+    }
+
+    // Tail that does not fill a vector
+    for (; i < n; i++) {
+        metrics_acc_add_times(&acc, t->burst_time[i], t->completion_time[i], t->turnaround_time[i],
+                              t->waiting_time[i], t->response_time[i]);
+    }
+
+    metrics_acc_finish(&acc, total_time, metrics);
+
+    if (total_time <= 0) {
+        metrics->cpu_utilization = 0;
+        metrics->throughput = 0;
     }
-}
\ No newline at end of file
+}
@@ -0,0 +1,203 @@
+#include <string.h>
+#include <limits.h>
+#include <time.h>
+#include "online.h"
+
+static uint64_t clock_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+int online_init(online_t *o, const sim_params_t *params, int capacity, online_emit_fn emit,
+                void *emit_ctx, timeline_t *timeline) {
+    memset(o, 0, sizeof(*o));
+    if (capacity < 1 || proc_table_init(&o->table, capacity) != 0) return -1;
+
+    // Rows are filled in on arrival; policies may look at them before that
+    proc_table_t *t = &o->table;
+    for (int i = 0; i < capacity; i++) {
+        t->arrival_time[i] = t->burst_time[i] = t->remaining_time[i] = t->priority[i] = 0;
+    }
+
+    o->p = sched_policy_create(params, t, 1, NULL);
+    if (!o->p) {
+        proc_table_free(t);
+        return -1;
+    }
+    o->capacity = capacity;
+    o->known = -1;
+    o->running = -1;
+    o->next_boost = o->p->boost_interval > 0 ? o->p->boost_interval : LLONG_MAX;
+    metrics_acc_init(&o->acc);
+    o->timeline = timeline;
+    o->emit = emit;
+    o->emit_ctx = emit_ctx;
+    if (timeline) timeline_clear(timeline);
+    return 0;
+}
+
+void online_free(online_t *o) {
+    sched_policy_destroy(o->p);
+    proc_table_free(&o->table);
+    memset(o, 0, sizeof(*o));
+}
+
+static void emit(online_t *o, online_event_kind_t kind, int time, int idx, int duration) {
+    online_event_t e = {kind, time, o->table.pid[idx], duration};
+    if (o->emit) o->emit(o->emit_ctx, &e);
+}
+
+// Runs the batch core's loop until the next step needs an arrival that may
+// not have been submitted yet
+static int drain(online_t *o) {
+    const sched_policy_ops_t *ops = o->p->ops;
+    sched_policy_t *p = o->p;
+    proc_table_t *t = &o->table;
+
+    for (;;) {
+        if (o->running >= 0) {
+            int idx = o->running;
+
+            // Arrival batches during the run, until one preempts it
+            if (ops->preempts) {
+                while (o->next < o->admitted && t->arrival_time[o->next] < o->run_end &&
+                       t->arrival_time[o->next] <= o->known) {
+                    int at = t->arrival_time[o->next];
+                    while (o->next < o->admitted && t->arrival_time[o->next] == at) {
+                        ops->enqueue(p, 0, o->next++);
+                        o->ready++;
+                    }
+                    if (ops->preempts(p, 0, idx, t->remaining_time[idx] - (at - o->run_start))) {
+                        o->run_end = at;
+                        emit(o, ONLINE_PREEMPT, at, idx, at - o->run_start);
+                        break;
+                    }
+                }
+            }
+
+            // Something arriving before the end could still cut the run short
+            if (o->run_end > o->known) return 0;
+
+            int run_time = (int)(o->run_end - o->run_start);
+            if (o->timeline && timeline_append(o->timeline, o->run_start, t->pid[idx], run_time) != 0) {
+                return -2;
+            }
+            t->remaining_time[idx] -= run_time;
+            o->now = (int)o->run_end;
+            o->running = -1;
+
+            // Jobs arriving during the run queue up ahead of the one being requeued
+            while (o->next < o->admitted && t->arrival_time[o->next] <= o->now) {
+                ops->enqueue(p, 0, o->next++);
+                o->ready++;
+            }
+
+            if (t->remaining_time[idx] == 0) {
+                o->completed++;
+                proc_table_finish(t, idx, o->now, &o->acc);
+                emit(o, ONLINE_COMPLETE, o->now, idx, 0);
+            } else {
+                ops->on_tick_expiry(p, 0, idx, run_time);
+                o->ready++;
+            }
+            continue;
+        }
+
+        // A decision at 'now' needs all of its arrivals
+        if (o->now > o->known) return 0;
+
+        while (o->next < o->admitted && t->arrival_time[o->next] <= o->now) {
+            ops->enqueue(p, 0, o->next++);
+            o->ready++;
+        }
+
+        if (o->now >= o->next_boost) {
+            if (o->ready > 0) ops->on_boost(p);
+            o->next_boost = (o->now / p->boost_interval + 1) * p->boost_interval;
+        }
+
+        // Idle CPU: jump to the next arrival, if it has been submitted
+        if (o->ready == 0) {
+            if (o->next == o->admitted) return 0;
+            o->now = t->arrival_time[o->next];
+            continue;
+        }
+
+        int idx = ops->pick_next(p, 0);
+        o->ready--;
+        if (t->remaining_time[idx] == t->burst_time[idx]) t->start_time[idx] = o->now;
+
+        long long run_time = t->remaining_time[idx];
+        int slice = ops->slice(p, idx);
+        if (slice < run_time) run_time = slice;
+        if (o->next_boost - o->now < run_time) run_time = o->next_boost - o->now;
+
+        o->running = idx;
+        o->run_start = o->now;
+        o->run_end = o->now + run_time;
+        emit(o, ONLINE_DISPATCH, o->now, idx, (int)run_time);
+
+        uint64_t now_ns = clock_ns();
+        uint64_t latency = now_ns - o->call_started;
+        histogram_add(&o->latency, latency < INT_MAX ? (int)latency : INT_MAX);
+        o->decisions++;
+        o->last_ns = now_ns;
+    }
+}
+
+int online_submit(online_t *o, int pid, int arrival, int burst, int priority) {
+    proc_table_t *t = &o->table;
+    if (o->admitted == o->capacity || arrival <= o->known || arrival < 0 || burst < 0 ||
+        (o->admitted > 0 && arrival < t->arrival_time[o->admitted - 1])) {
+        return -1;
+    }
+
+    o->call_started = clock_ns();
+    if (o->admitted == 0) o->first_ns = o->call_started;
+
+    int idx = o->admitted++;
+    t->pid[idx] = pid;
+    t->arrival_time[idx] = arrival;
+    t->burst_time[idx] = burst;
+    t->remaining_time[idx] = burst;
+    t->priority[idx] = priority;
+    t->start_time[idx] = 0;
+    if (o->p->ops->reset) o->p->ops->reset(o->p, idx);
+
+    // Arrivals come in time order, so everything before this one is in
+    int result = 0;
+    if (arrival - 1 > o->known) {
+        o->known = arrival - 1;
+        result = drain(o);
+    }
+    o->engine_ns += clock_ns() - o->call_started;
+    return result;
+}
+
+int online_advance(online_t *o, int time) {
+    if (time <= o->known) return 0;
+
+    o->call_started = clock_ns();
+    o->known = time;
+    int result = drain(o);
+    o->engine_ns += clock_ns() - o->call_started;
+    return result;
+}
+
+void online_report(const online_t *o, online_report_t *report) {
+    memset(report, 0, sizeof(*report));
+    report->jobs = o->admitted;
+    report->completed = o->completed;
+    report->decisions = o->decisions;
+    report->latency_p50 = histogram_percentile(&o->latency, o->decisions, 0.50);
+    report->latency_p99 = histogram_percentile(&o->latency, o->decisions, 0.99);
+    report->latency_p999 = histogram_percentile(&o->latency, o->decisions, 0.999);
+    report->latency_max = o->decisions ? o->latency.max : 0;
+
+    double wall = o->decisions ? (double)(o->last_ns - o->first_ns) / 1e9 : 0;
+    double engine = (double)o->engine_ns / 1e9;
+    if (wall > 0) report->decisions_per_sec = o->decisions / wall;
+    if (engine > 0) report->engine_decisions_per_sec = o->decisions / engine;
+    metrics_acc_finish(&o->acc, 0, &report->metrics);
+}
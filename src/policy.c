@@ -0,0 +1,1184 @@
+#include <string.h>
+#include <limits.h>
+#include "policy.h"
+#include "pqueue.h"
+#include "rbtree.h"
+#include "fenwick.h"
+#include "rng.h"
+#include "instrument.h"
+
+// ------------------------------------------------------
+// List policies: FIFO, Round Robin, MLFQ, static priority
+// ------------------------------------------------------
+// Each queue keeps one FIFO per level, an intrusive singly linked list
+// threaded through 'link', and a bitmap of non-empty levels gives the
+// highest ready level with one find-first-set. FIFO and RR use one level.
+// Dispatch never looks at more than one job, however many are ready.
+//
+// MLFQ rules:
+// - New arrivals enter the tail of level 0.
+// - A job that uses up its level's quantum moves one level down (tail).
+// - A job cut short by an arrival, a boost or a preemption keeps its place
+//   at the head of its level and the unused part of its quantum.
+// - Every boost_interval ticks all unfinished jobs return to level 0.
+//   Boosting splices the level lists together in O(levels); each job's level
+//   and quantum usage are reset lazily the next time it is picked.
+
+typedef struct {
+    sched_policy_t base;
+    int levels;
+    int quantum;                        // RR
+    int quantums[MLFQ_MAX_QUEUES];      // MLFQ, at least 1 each
+    int *link;                          // Next job in the same level
+    int *head;                          // First job per queue and level (-1 when empty)
+    int *tail;                          // Last job per queue and level
+    uint64_t *nonempty;                 // Per queue: bit q set <=> level q has ready jobs
+    int *slice_used;                    // MLFQ: quantum used at the current level
+    int *epoch;                         // MLFQ: last boost each job has seen
+    int boost_epoch;
+    int *level;                         // MLFQ: level each job is at; priority: level it
+                                        // was last picked from
+} list_policy_t;
+
+static void list_destroy(sched_policy_t *p) {
+    list_policy_t *lp = (list_policy_t *)p;
+    arena_release(p->arena, lp->link);
+    arena_release(p->arena, lp->head);
+    arena_release(p->arena, lp->nonempty);
+    arena_release(p->arena, lp->slice_used);
+    arena_release(p->arena, lp->epoch);
+    arena_release(p->arena, lp->level);
+    arena_release(p->arena, lp);
+}
+
+static void list_push_back(list_policy_t *lp, int q, int level, int idx) {
+    int slot = q * lp->levels + level;
+    lp->link[idx] = -1;
+    if (lp->head[slot] == -1) lp->head[slot] = idx;
+    else lp->link[lp->tail[slot]] = idx;
+    lp->tail[slot] = idx;
+    lp->nonempty[q] |= (uint64_t)1 << level;
+}
+
+static void list_push_front(list_policy_t *lp, int q, int level, int idx) {
+    int slot = q * lp->levels + level;
+    lp->link[idx] = lp->head[slot];
+    if (lp->head[slot] == -1) lp->tail[slot] = idx;
+    lp->head[slot] = idx;
+    lp->nonempty[q] |= (uint64_t)1 << level;
+}
+
+static void list_enqueue(sched_policy_t *p, int q, int idx) {
+    list_push_back((list_policy_t *)p, q, 0, idx);
+}
+
+static int list_pick_next(sched_policy_t *p, int q) {
+    list_policy_t *lp = (list_policy_t *)p;
+    int level = __builtin_ctzll(lp->nonempty[q]);
+    int slot = q * lp->levels + level;
+    int idx = lp->head[slot];
+    lp->head[slot] = lp->link[idx];
+    if (lp->head[slot] == -1) lp->nonempty[q] &= ~((uint64_t)1 << level);
+    return idx;
+}
+
+static void list_on_tick_expiry(sched_policy_t *p, int q, int idx, int ran) {
+    (void)ran;
+    list_push_back((list_policy_t *)p, q, 0, idx);
+}
+
+// Takes the tails of the lowest levels. Jobs keep their level (and MLFQ
+// quantum usage and boost epoch) and their order.
+static void list_migrate(sched_policy_t *p, int from, int to, int count) {
+    list_policy_t *lp = (list_policy_t *)p;
+    for (int level = lp->levels - 1; level >= 0 && count > 0; level--) {
+        int slot = from * lp->levels + level;
+        if (lp->head[slot] == -1) continue;
+
+        int length = 0;
+        for (int idx = lp->head[slot]; idx != -1; idx = lp->link[idx]) length++;
+        int keep = length > count ? length - count : 0;
+        count -= length - keep;
+
+        // Cut the level after its first 'keep' jobs
+        int idx = lp->head[slot];
+        if (keep == 0) {
+            lp->head[slot] = -1;
+            lp->nonempty[from] &= ~((uint64_t)1 << level);
+        } else {
+            int last = idx;
+            for (int k = 1; k < keep; k++) last = lp->link[last];
+            idx = lp->link[last];
+            lp->link[last] = -1;
+            lp->tail[slot] = last;
+        }
+        while (idx != -1) {
+            int next = lp->link[idx];
+            list_push_back(lp, to, level, idx);
+            idx = next;
+        }
+    }
+}
+
+static int fifo_slice(const sched_policy_t *p, int idx) {
+    (void)p; (void)idx;
+    return INT_MAX;
+}
+
+static int rr_slice(const sched_policy_t *p, int idx) {
+    (void)idx;
+    return ((const list_policy_t *)p)->quantum;
+}
+
+// Queue 'q' from its top level down, the order restore rebuilds it in
+static int list_capture(const sched_policy_t *p, int q, sim_session_t *s, checkpoint_t *cp) {
+    const list_policy_t *lp = (const list_policy_t *)p;
+    const proc_table_t *t = p->t;
+    int mlfq = lp->slice_used != NULL;
+
+    cp->boost_epoch = lp->boost_epoch;
+    for (int level = 0; level < lp->levels; level++) {
+        for (int idx = lp->head[q * lp->levels + level]; idx != -1; idx = lp->link[idx]) {
+            checkpoint_entry_t e = {0};
+            e.idx = idx;
+            e.remaining_time = t->remaining_time[idx];
+            e.start_time = t->start_time[idx];
+            e.level = level;
+            if (mlfq) {
+                e.priority = lp->level[idx];
+                e.slice_used = lp->slice_used[idx];
+                e.stale = lp->epoch[idx] != lp->boost_epoch;
+            }
+            if (checkpoint_add(s, cp, &e) != 0) return -1;
+        }
+    }
+    return 0;
+}
+
+static void list_restore(sched_policy_t *p, int q, const sim_session_t *s, const checkpoint_t *cp) {
+    list_policy_t *lp = (list_policy_t *)p;
+    proc_table_t *t = p->t;
+    int mlfq = lp->slice_used != NULL;
+
+    lp->boost_epoch = cp->boost_epoch;
+    for (int k = 0; k < cp->entry_count; k++) {
+        const checkpoint_entry_t *e = &s->entries[cp->first_entry + k];
+        t->remaining_time[e->idx] = e->remaining_time;
+        t->start_time[e->idx] = e->start_time;
+        if (mlfq) {
+            lp->level[e->idx] = e->priority;
+            lp->slice_used[e->idx] = e->slice_used;
+            lp->epoch[e->idx] = e->stale ? lp->boost_epoch - 1 : lp->boost_epoch;
+        }
+        list_push_back(lp, q, e->level, e->idx);
+    }
+}
+
+// --- MLFQ ---
+// The level a job is at lives in 'level', so the caller's priorities are
+// left alone
+
+static void mlfq_reset(sched_policy_t *p, int idx) {
+    list_policy_t *lp = (list_policy_t *)p;
+    lp->level[idx] = 0; // Start at highest priority (0)
+    lp->slice_used[idx] = 0;
+}
+
+static void mlfq_enqueue(sched_policy_t *p, int q, int idx) {
+    list_policy_t *lp = (list_policy_t *)p;
+    lp->epoch[idx] = lp->boost_epoch;
+    list_push_back(lp, q, lp->level[idx], idx);
+}
+
+static int mlfq_pick_next(sched_policy_t *p, int q) {
+    list_policy_t *lp = (list_policy_t *)p;
+    int idx = list_pick_next(p, q);
+
+    // A job that missed a boost starts over at the top level
+    if (lp->epoch[idx] != lp->boost_epoch) {
+        lp->epoch[idx] = lp->boost_epoch;
+        lp->level[idx] = 0;
+        lp->slice_used[idx] = 0;
+    }
+    return idx;
+}
+
+static int mlfq_slice(const sched_policy_t *p, int idx) {
+    const list_policy_t *lp = (const list_policy_t *)p;
+    return lp->quantums[lp->level[idx]] - lp->slice_used[idx];
+}
+
+static void mlfq_on_tick_expiry(sched_policy_t *p, int q, int idx, int ran) {
+    list_policy_t *lp = (list_policy_t *)p;
+    int *level = &lp->level[idx];
+
+    lp->slice_used[idx] += ran;
+    if (lp->slice_used[idx] >= lp->quantums[*level]) {
+        // Downgrade priority if not already at bottom, with a fresh quantum
+        if (*level < lp->levels - 1) {
+            (*level)++;
+            SCHED_COUNT(demotions);
+        }
+        lp->slice_used[idx] = 0;
+        list_push_back(lp, q, *level, idx);
+    } else {
+        list_push_front(lp, q, *level, idx);
+    }
+}
+
+// Appends every lower level to level 0, preserving order within each level
+static void mlfq_on_boost(sched_policy_t *p) {
+    list_policy_t *lp = (list_policy_t *)p;
+    for (int q = 0; q < p->nr_queues; q++) {
+        int *head = &lp->head[q * lp->levels];
+        int *tail = &lp->tail[q * lp->levels];
+        for (int level = 1; level < lp->levels; level++) {
+            if (head[level] == -1) continue;
+            if (head[0] == -1) head[0] = head[level];
+            else lp->link[tail[0]] = head[level];
+            tail[0] = tail[level];
+            head[level] = -1;
+        }
+        if (lp->nonempty[q]) lp->nonempty[q] = 1;
+    }
+    lp->boost_epoch++;
+}
+
+static int mlfq_preempts(const sched_policy_t *p, int q, int running, int left) {
+    (void)left;
+    const list_policy_t *lp = (const list_policy_t *)p;
+    return __builtin_ctzll(lp->nonempty[q]) < lp->level[running];
+}
+
+static long long mlfq_rank(const sched_policy_t *p, int running, int left) {
+    (void)left;
+    return ((const list_policy_t *)p)->level[running];
+}
+
+static const sched_policy_ops_t fifo_ops = {
+    .name = "FIFO",
+    .admit_by_index = 1,
+    .destroy = list_destroy,
+    .enqueue = list_enqueue,
+    .pick_next = list_pick_next,
+    .slice = fifo_slice,
+    .on_tick_expiry = list_on_tick_expiry,
+    .migrate = list_migrate,
+    .capture = list_capture,
+    .restore = list_restore,
+};
+
+static const sched_policy_ops_t rr_ops = {
+    .name = "Round Robin",
+    .destroy = list_destroy,
+    .enqueue = list_enqueue,
+    .pick_next = list_pick_next,
+    .slice = rr_slice,
+    .on_tick_expiry = list_on_tick_expiry,
+    .migrate = list_migrate,
+    .capture = list_capture,
+    .restore = list_restore,
+};
+
+static const sched_policy_ops_t mlfq_ops = {
+    .name = "MLFQ",
+    .destroy = list_destroy,
+    .reset = mlfq_reset,
+    .enqueue = mlfq_enqueue,
+    .pick_next = mlfq_pick_next,
+    .slice = mlfq_slice,
+    .on_tick_expiry = mlfq_on_tick_expiry,
+    .migrate = list_migrate,
+    .on_boost = mlfq_on_boost,
+    .preempts = mlfq_preempts,
+    .rank = mlfq_rank,
+    .capture = list_capture,
+    .restore = list_restore,
+};
+
+// --- Static priority ---
+// Modeled on the Linux O(1) scheduler: the priority column picks the level
+// (0 runs first), jobs in a level are served FIFO, and a job keeps the CPU
+// until it finishes or, in the preemptive variant, a job on a strictly
+// higher level arrives. The preempted job returns to the head of its level.
+//
+// Aging: every boost_interval ticks each level's waiting jobs move up one
+// level, splicing the lists in O(levels). A job runs at the level it was
+// picked from and returns to its own level once it has been cut short.
+
+static int prio_level(const list_policy_t *lp, int idx) {
+    int prio = lp->base.t->priority[idx];
+    if (prio < 0) return 0;
+    return prio < lp->levels ? prio : lp->levels - 1;
+}
+
+static void prio_enqueue(sched_policy_t *p, int q, int idx) {
+    list_policy_t *lp = (list_policy_t *)p;
+    list_push_back(lp, q, prio_level(lp, idx), idx);
+}
+
+static int prio_pick_next(sched_policy_t *p, int q) {
+    list_policy_t *lp = (list_policy_t *)p;
+    int level = __builtin_ctzll(lp->nonempty[q]);
+    int idx = list_pick_next(p, q);
+    lp->level[idx] = level;
+    return idx;
+}
+
+// Non-preemptive: only aging cuts a run short, and the job must run on, so
+// it goes back to the very head of the queue
+static void prio_on_tick_expiry(sched_policy_t *p, int q, int idx, int ran) {
+    (void)ran;
+    list_push_front((list_policy_t *)p, q, 0, idx);
+}
+
+static void prio_preempt_on_tick_expiry(sched_policy_t *p, int q, int idx, int ran) {
+    (void)ran;
+    list_policy_t *lp = (list_policy_t *)p;
+    list_push_front(lp, q, prio_level(lp, idx), idx);
+}
+
+// Appends every level to the one above it; level 0 absorbs level 1
+static void prio_on_boost(sched_policy_t *p) {
+    list_policy_t *lp = (list_policy_t *)p;
+    for (int q = 0; q < p->nr_queues; q++) {
+        int *head = &lp->head[q * lp->levels];
+        int *tail = &lp->tail[q * lp->levels];
+        for (int level = 1; level < lp->levels; level++) {
+            if (head[level] == -1) continue;
+            if (head[level - 1] == -1) head[level - 1] = head[level];
+            else lp->link[tail[level - 1]] = head[level];
+            tail[level - 1] = tail[level];
+            head[level] = -1;
+        }
+        lp->nonempty[q] = (lp->nonempty[q] >> 1) | (lp->nonempty[q] & 1);
+    }
+}
+
+static int prio_preempts(const sched_policy_t *p, int q, int running, int left) {
+    (void)left;
+    const list_policy_t *lp = (const list_policy_t *)p;
+    return __builtin_ctzll(lp->nonempty[q]) < lp->level[running];
+}
+
+static long long prio_rank(const sched_policy_t *p, int running, int left) {
+    (void)left;
+    return ((const list_policy_t *)p)->level[running];
+}
+
+static const sched_policy_ops_t prio_ops = {
+    .name = "Priority",
+    .destroy = list_destroy,
+    .enqueue = prio_enqueue,
+    .pick_next = prio_pick_next,
+    .slice = fifo_slice,
+    .on_tick_expiry = prio_on_tick_expiry,
+    .migrate = list_migrate,
+    .on_boost = prio_on_boost,
+    .capture = list_capture,
+    .restore = list_restore,
+};
+
+static const sched_policy_ops_t prio_preempt_ops = {
+    .name = "Priority (P)",
+    .destroy = list_destroy,
+    .enqueue = prio_enqueue,
+    .pick_next = prio_pick_next,
+    .slice = fifo_slice,
+    .on_tick_expiry = prio_preempt_on_tick_expiry,
+    .migrate = list_migrate,
+    .on_boost = prio_on_boost,
+    .preempts = prio_preempts,
+    .rank = prio_rank,
+    .capture = list_capture,
+    .restore = list_restore,
+};
+
+static sched_policy_t *list_create(const sched_policy_ops_t *ops, proc_table_t *t, int nr_queues,
+                                   int levels, arena_t *arena) {
+    size_t jobs = sizeof(int) * (t->n > 0 ? t->n : 1);
+    size_t slots = (size_t)nr_queues * levels;
+    list_policy_t *lp = arena_calloc(arena, 1, sizeof(list_policy_t));
+    if (!lp) return NULL;
+
+    lp->base.ops = ops;
+    lp->base.t = t;
+    lp->base.nr_queues = nr_queues;
+    lp->base.arena = arena;
+    lp->levels = levels;
+    lp->link = arena_alloc(arena, jobs);
+    lp->head = arena_alloc(arena, sizeof(int) * 2 * slots);
+    lp->nonempty = arena_calloc(arena, nr_queues, sizeof(uint64_t));
+    if (ops == &mlfq_ops) {
+        lp->slice_used = arena_alloc(arena, jobs);
+        lp->epoch = arena_alloc(arena, jobs);
+    }
+    int leveled = ops == &mlfq_ops || ops == &prio_ops || ops == &prio_preempt_ops;
+    if (leveled) lp->level = arena_alloc(arena, jobs);
+    if (!lp->link || !lp->head || !lp->nonempty || (ops == &mlfq_ops && (!lp->slice_used || !lp->epoch)) ||
+        (leveled && !lp->level)) {
+        list_destroy(&lp->base);
+        return NULL;
+    }
+    lp->tail = lp->head + slots;
+    for (size_t k = 0; k < slots; k++) lp->head[k] = lp->tail[k] = -1;
+    return &lp->base;
+}
+
+// ------------------------------------------------------
+// Heap policies: SJF, STCF
+// ------------------------------------------------------
+// Each queue is a binary heap. SJF never preempts; STCF's running job only
+// loses the CPU to a job with less remaining time.
+
+typedef struct {
+    sched_policy_t base;
+    pqueue_t *heaps;
+} heap_policy_t;
+
+// Heap order: shortest burst, then earliest arrival, then lowest index
+static int sjf_less(const void *ctx, int a, int b) {
+    const proc_table_t *t = ctx;
+    if (t->burst_time[a] != t->burst_time[b]) {
+        return t->burst_time[a] < t->burst_time[b];
+    }
+    if (t->arrival_time[a] != t->arrival_time[b]) {
+        return t->arrival_time[a] < t->arrival_time[b];
+    }
+    return a < b;
+}
+
+// Heap order: least remaining time, then earliest arrival, then lowest index
+static int stcf_less(const void *ctx, int a, int b) {
+    const proc_table_t *t = ctx;
+    if (t->remaining_time[a] != t->remaining_time[b]) {
+        return t->remaining_time[a] < t->remaining_time[b];
+    }
+    if (t->arrival_time[a] != t->arrival_time[b]) {
+        return t->arrival_time[a] < t->arrival_time[b];
+    }
+    return a < b;
+}
+
+static void heap_destroy(sched_policy_t *p) {
+    heap_policy_t *hp = (heap_policy_t *)p;
+    for (int q = 0; q < p->nr_queues && hp->heaps; q++) pqueue_free(&hp->heaps[q]);
+    arena_release(p->arena, hp->heaps);
+    arena_release(p->arena, hp);
+}
+
+static void heap_enqueue(sched_policy_t *p, int q, int idx) {
+    pqueue_t *heap = &((heap_policy_t *)p)->heaps[q];
+    if (heap->size == heap->capacity && pqueue_reserve(heap, heap->capacity * 2 + 16) != 0) {
+        p->failed = 1;
+        return;
+    }
+    pqueue_push(heap, idx);
+}
+
+static int heap_pick_next(sched_policy_t *p, int q) {
+    return pqueue_pop(&((heap_policy_t *)p)->heaps[q]);
+}
+
+// Takes the last leaves, through the policy's own enqueue (stride uses it too)
+static void heap_migrate(sched_policy_t *p, int from, int to, int count) {
+    pqueue_t *heap = &((heap_policy_t *)p)->heaps[from];
+    for (int k = 0; k < count; k++) p->ops->enqueue(p, to, pqueue_pop_last(heap));
+}
+
+static int heap_slice(const sched_policy_t *p, int idx) {
+    (void)p; (void)idx;
+    return INT_MAX;
+}
+
+static void heap_on_tick_expiry(sched_policy_t *p, int q, int idx, int ran) {
+    (void)ran;
+    heap_enqueue(p, q, idx);
+}
+
+static int stcf_preempts(const sched_policy_t *p, int q, int running, int left) {
+    const proc_table_t *t = p->t;
+    int best = pqueue_peek(&((const heap_policy_t *)p)->heaps[q]);
+    if (t->remaining_time[best] != left) return t->remaining_time[best] < left;
+    if (t->arrival_time[best] != t->arrival_time[running]) {
+        return t->arrival_time[best] < t->arrival_time[running];
+    }
+    return best < running;
+}
+
+static long long stcf_rank(const sched_policy_t *p, int running, int left) {
+    (void)p; (void)running;
+    return left;
+}
+
+// The heap array is stored as is: pushing it back in the same order
+// rebuilds the same heap
+static int heap_capture(const sched_policy_t *p, int q, sim_session_t *s, checkpoint_t *cp) {
+    const pqueue_t *heap = &((const heap_policy_t *)p)->heaps[q];
+    for (int k = 0; k < heap->size; k++) {
+        checkpoint_entry_t e = {0};
+        e.idx = heap->items[k];
+        e.remaining_time = p->t->remaining_time[e.idx];
+        e.start_time = p->t->start_time[e.idx];
+        if (checkpoint_add(s, cp, &e) != 0) return -1;
+    }
+    return 0;
+}
+
+static void heap_restore(sched_policy_t *p, int q, const sim_session_t *s, const checkpoint_t *cp) {
+    for (int k = 0; k < cp->entry_count; k++) {
+        const checkpoint_entry_t *e = &s->entries[cp->first_entry + k];
+        p->t->remaining_time[e->idx] = e->remaining_time;
+        p->t->start_time[e->idx] = e->start_time;
+        heap_enqueue(p, q, e->idx);
+    }
+}
+
+static const sched_policy_ops_t sjf_ops = {
+    .name = "SJF",
+    .destroy = heap_destroy,
+    .enqueue = heap_enqueue,
+    .pick_next = heap_pick_next,
+    .slice = heap_slice,
+    .on_tick_expiry = heap_on_tick_expiry,
+    .migrate = heap_migrate,
+    .capture = heap_capture,
+    .restore = heap_restore,
+};
+
+static const sched_policy_ops_t stcf_ops = {
+    .name = "STCF",
+    .destroy = heap_destroy,
+    .enqueue = heap_enqueue,
+    .pick_next = heap_pick_next,
+    .slice = heap_slice,
+    .on_tick_expiry = heap_on_tick_expiry,
+    .migrate = heap_migrate,
+    .preempts = stcf_preempts,
+    .rank = stcf_rank,
+    .capture = heap_capture,
+    .restore = heap_restore,
+};
+
+// Sets up the queues of a zeroed heap policy; on failure the caller destroys it
+static int heap_init(heap_policy_t *hp, const sched_policy_ops_t *ops, proc_table_t *t, int nr_queues,
+                     pqueue_less_fn less, const void *ctx, arena_t *arena) {
+    hp->base.ops = ops;
+    hp->base.t = t;
+    hp->base.nr_queues = nr_queues;
+    hp->base.arena = arena;
+    hp->heaps = arena_calloc(arena, nr_queues, sizeof(pqueue_t));
+    if (!hp->heaps) return -1;
+
+    // A single queue can hold every job; per-core queues start small and grow
+    int capacity = nr_queues == 1 ? t->n : 16;
+    for (int q = 0; q < nr_queues; q++) {
+        if (pqueue_init(&hp->heaps[q], capacity, less, ctx, arena) != 0) return -1;
+    }
+    return 0;
+}
+
+static sched_policy_t *heap_create(const sched_policy_ops_t *ops, proc_table_t *t, int nr_queues,
+                                   arena_t *arena) {
+    heap_policy_t *hp = arena_calloc(arena, 1, sizeof(heap_policy_t));
+    if (!hp) return NULL;
+
+    if (heap_init(hp, ops, t, nr_queues, ops == &sjf_ops ? sjf_less : stcf_less, t, arena) != 0) {
+        heap_destroy(&hp->base);
+        return NULL;
+    }
+    return &hp->base;
+}
+
+// ------------------------------------------------------
+// CFS (Completely Fair Scheduler)
+// ------------------------------------------------------
+// Each queue is a red-black tree ordered by virtual runtime: the time a job
+// has run, scaled by NICE_0_WEIGHT / weight. The leftmost job runs next, for
+// a slice of the scheduling period proportional to its weight. min_vruntime
+// only moves forward; new jobs start at it, so they neither starve the queue
+// nor get starved. A job that changes queue (SMP) keeps its lag behind the
+// old queue's min_vruntime.
+
+#define CFS_NICE_0_WEIGHT 1024
+#define CFS_SHIFT 20            // vruntime fixed point: 1 << CFS_SHIFT per tick at nice 0
+
+// Linux's sched_prio_to_weight: nice -20 .. 19, about 1.25x per step
+static const int cfs_weights[40] = {
+    88761, 71755, 56483, 46273, 36291,
+    29154, 23254, 18705, 14949, 11916,
+     9548,  7620,  6100,  4904,  3906,
+     3121,  2501,  1991,  1586,  1277,
+     1024,   820,   655,   526,   423,
+      335,   272,   215,   172,   137,
+      110,    87,    70,    56,    45,
+       36,    29,    23,    18,    15,
+};
+
+void cfs_default_config(cfs_config_t *config) {
+    config->sched_latency = 24;
+    config->min_granularity = 3;
+}
+
+typedef struct {
+    sched_policy_t base;
+    int sched_latency;
+    int min_granularity;
+    rb_nodes_t nodes;
+    rbtree_t *trees;            // Per queue
+    long long *min_vruntime;    // Per queue
+    long long *load;            // Per queue: total weight of the queued jobs
+    long long *vruntime;        // Per job
+    int *weight;                // Per job
+    int *home;                  // Per job: queue it was last put on, -1 before its arrival
+} cfs_policy_t;
+
+// Tree order: least vruntime, then lowest index
+static int cfs_less(const void *ctx, int a, int b) {
+    const long long *vruntime = ctx;
+    if (vruntime[a] != vruntime[b]) return vruntime[a] < vruntime[b];
+    return a < b;
+}
+
+// Virtual time for 'ticks' of real time at 'weight'
+static long long cfs_scale(long long ticks, int weight) {
+    return (ticks << CFS_SHIFT) * CFS_NICE_0_WEIGHT / weight;
+}
+
+static void cfs_destroy(sched_policy_t *p) {
+    cfs_policy_t *cp = (cfs_policy_t *)p;
+    rb_nodes_free(&cp->nodes);
+    arena_release(p->arena, cp->trees);
+    arena_release(p->arena, cp->min_vruntime);
+    arena_release(p->arena, cp->load);
+    arena_release(p->arena, cp->vruntime);
+    arena_release(p->arena, cp->weight);
+    arena_release(p->arena, cp->home);
+    arena_release(p->arena, cp);
+}
+
+// Kernel load weight of the job's nice value
+static int cfs_weight_of(const proc_table_t *t, int idx) {
+    int nice = t->priority[idx];
+    if (nice < -20) nice = -20;
+    if (nice > 19) nice = 19;
+    return cfs_weights[nice + 20];
+}
+
+// Also picks up the weight, for rows filled in after the policy was built
+static void cfs_reset(sched_policy_t *p, int idx) {
+    cfs_policy_t *cp = (cfs_policy_t *)p;
+    cp->weight[idx] = cfs_weight_of(p->t, idx);
+    cp->vruntime[idx] = 0;
+    cp->home[idx] = -1;
+}
+
+static void cfs_insert(cfs_policy_t *cp, int q, int idx) {
+    rbtree_insert(&cp->nodes, &cp->trees[q], idx);
+    cp->load[q] += cp->weight[idx];
+    cp->home[idx] = q;
+}
+
+// min_vruntime follows the leftmost job but never moves back
+static void cfs_update_min(cfs_policy_t *cp, int q, long long vruntime) {
+    if (vruntime > cp->min_vruntime[q]) cp->min_vruntime[q] = vruntime;
+}
+
+static void cfs_enqueue(sched_policy_t *p, int q, int idx) {
+    cfs_policy_t *cp = (cfs_policy_t *)p;
+    int from = cp->home[idx];
+
+    if (from < 0) cp->vruntime[idx] = cp->min_vruntime[q];
+    else if (from != q) cp->vruntime[idx] += cp->min_vruntime[q] - cp->min_vruntime[from];
+    cfs_insert(cp, q, idx);
+}
+
+static int cfs_pick_next(sched_policy_t *p, int q) {
+    cfs_policy_t *cp = (cfs_policy_t *)p;
+    int idx = rbtree_first(&cp->trees[q]);
+
+    rbtree_erase(&cp->nodes, &cp->trees[q], idx);
+    cp->load[q] -= cp->weight[idx];
+    cfs_update_min(cp, q, cp->vruntime[idx]);
+    return idx;
+}
+
+// Takes the jobs furthest right. They keep their lag behind min_vruntime,
+// which stays where it is.
+static void cfs_migrate(sched_policy_t *p, int from, int to, int count) {
+    cfs_policy_t *cp = (cfs_policy_t *)p;
+    rbtree_t *tree = &cp->trees[from];
+    int idx = rbtree_first(tree);
+
+    for (int k = tree->size - count; k > 0; k--) idx = rbtree_next(&cp->nodes, idx);
+    while (idx >= 0) {
+        int next = rbtree_next(&cp->nodes, idx);
+        rbtree_erase(&cp->nodes, tree, idx);
+        cp->load[from] -= cp->weight[idx];
+        cfs_enqueue(p, to, idx);
+        idx = next;
+    }
+}
+
+// The job's share of max(sched_latency, runnable * min_granularity),
+// counting itself among the runnable jobs of the queue it came from
+static int cfs_slice(const sched_policy_t *p, int idx) {
+    const cfs_policy_t *cp = (const cfs_policy_t *)p;
+    int q = cp->home[idx];
+    long long runnable = cp->trees[q].size + 1;
+    long long period = runnable * cp->min_granularity;
+    if (period < cp->sched_latency) period = cp->sched_latency;
+
+    long long slice = period * cp->weight[idx] / (cp->load[q] + cp->weight[idx]);
+    if (slice < cp->min_granularity) slice = cp->min_granularity;
+    if (slice < 1) slice = 1;
+    return slice > INT_MAX ? INT_MAX : (int)slice;
+}
+
+static void cfs_on_tick_expiry(sched_policy_t *p, int q, int idx, int ran) {
+    cfs_policy_t *cp = (cfs_policy_t *)p;
+    cp->vruntime[idx] += cfs_scale(ran, cp->weight[idx]);
+    cfs_insert(cp, q, idx);
+    cfs_update_min(cp, q, cp->vruntime[rbtree_first(&cp->trees[q])]);
+}
+
+// Virtual runtime of 'running' including the part of its slice so far
+static long long cfs_current(const cfs_policy_t *cp, int running, int left) {
+    int ran = cp->base.t->remaining_time[running] - left;
+    return cp->vruntime[running] + cfs_scale(ran, cp->weight[running]);
+}
+
+// Wakeup preemption: the leftmost job must be behind by more than
+// min_granularity (in its own virtual time)
+static int cfs_preempts(const sched_policy_t *p, int q, int running, int left) {
+    const cfs_policy_t *cp = (const cfs_policy_t *)p;
+    int best = rbtree_first(&cp->trees[q]);
+    long long margin = cfs_scale(cp->min_granularity, cp->weight[best]);
+    return cfs_current(cp, running, left) - cp->vruntime[best] > margin;
+}
+
+static long long cfs_rank(const sched_policy_t *p, int running, int left) {
+    return cfs_current((const cfs_policy_t *)p, running, left);
+}
+
+static int cfs_capture(const sched_policy_t *p, int q, sim_session_t *s, checkpoint_t *cp) {
+    const cfs_policy_t *c = (const cfs_policy_t *)p;
+
+    cp->virtual_clock = c->min_vruntime[q];
+    for (int idx = rbtree_first(&c->trees[q]); idx != -1; idx = rbtree_next(&c->nodes, idx)) {
+        checkpoint_entry_t e = {0};
+        e.idx = idx;
+        e.remaining_time = p->t->remaining_time[idx];
+        e.start_time = p->t->start_time[idx];
+        e.virtual_time = c->vruntime[idx];
+        if (checkpoint_add(s, cp, &e) != 0) return -1;
+    }
+    return 0;
+}
+
+static void cfs_restore(sched_policy_t *p, int q, const sim_session_t *s, const checkpoint_t *cp) {
+    cfs_policy_t *c = (cfs_policy_t *)p;
+
+    c->min_vruntime[q] = cp->virtual_clock;
+    for (int k = 0; k < cp->entry_count; k++) {
+        const checkpoint_entry_t *e = &s->entries[cp->first_entry + k];
+        p->t->remaining_time[e->idx] = e->remaining_time;
+        p->t->start_time[e->idx] = e->start_time;
+        c->vruntime[e->idx] = e->virtual_time;
+        cfs_insert(c, q, e->idx);
+    }
+}
+
+static const sched_policy_ops_t cfs_ops = {
+    .name = "CFS",
+    .destroy = cfs_destroy,
+    .reset = cfs_reset,
+    .enqueue = cfs_enqueue,
+    .pick_next = cfs_pick_next,
+    .slice = cfs_slice,
+    .on_tick_expiry = cfs_on_tick_expiry,
+    .migrate = cfs_migrate,
+    .preempts = cfs_preempts,
+    .rank = cfs_rank,
+    .capture = cfs_capture,
+    .restore = cfs_restore,
+};
+
+static sched_policy_t *cfs_create(proc_table_t *t, int nr_queues, const cfs_config_t *config,
+                                  arena_t *arena) {
+    size_t jobs = t->n > 0 ? t->n : 1;
+    cfs_policy_t *cp = arena_calloc(arena, 1, sizeof(cfs_policy_t));
+    if (!cp) return NULL;
+
+    cfs_config_t defaults;
+    if (!config) {
+        cfs_default_config(&defaults);
+        config = &defaults;
+    }
+    cp->base.ops = &cfs_ops;
+    cp->base.t = t;
+    cp->base.nr_queues = nr_queues;
+    cp->base.arena = arena;
+    cp->sched_latency = config->sched_latency < 1 ? 1 : config->sched_latency;
+    cp->min_granularity = config->min_granularity < 1 ? 1 : config->min_granularity;
+    cp->trees = arena_alloc(arena, sizeof(rbtree_t) * nr_queues);
+    cp->min_vruntime = arena_calloc(arena, nr_queues, sizeof(long long));
+    cp->load = arena_calloc(arena, nr_queues, sizeof(long long));
+    cp->vruntime = arena_alloc(arena, sizeof(long long) * jobs);
+    cp->weight = arena_alloc(arena, sizeof(int) * jobs);
+    cp->home = arena_alloc(arena, sizeof(int) * jobs);
+    if (!cp->trees || !cp->min_vruntime || !cp->load || !cp->vruntime || !cp->weight || !cp->home) {
+        cfs_destroy(&cp->base);
+        return NULL;
+    }
+
+    for (int i = 0; i < t->n; i++) {
+        cp->weight[i] = cfs_weight_of(t, i);
+        cp->vruntime[i] = 0;
+        cp->home[i] = -1;
+    }
+    if (rb_nodes_init(&cp->nodes, t->n, cfs_less, cp->vruntime, arena) != 0) {
+        cfs_destroy(&cp->base);
+        return NULL;
+    }
+    for (int q = 0; q < nr_queues; q++) rbtree_init(&cp->nodes, &cp->trees[q]);
+    return &cp->base;
+}
+
+// ------------------------------------------------------
+// Lottery and stride scheduling
+// ------------------------------------------------------
+// Proportional share: a job's priority is its ticket count (at least 1),
+// and both policies run the chosen job for one quantum.
+
+static int tickets_of(const proc_table_t *t, int idx) {
+    return t->priority[idx] < 1 ? 1 : t->priority[idx];
+}
+
+// --- Lottery ---
+// Each queue packs its jobs into slots [0, size) of a Fenwick tree over
+// their tickets. A draw picks a uniform ticket and finds its slot in
+// O(log n); the last slot's job fills the hole, so the layout depends only
+// on the order of queue operations and a snapshot can rebuild it.
+
+typedef struct {
+    int size;
+    int *jobs;              // Job in each slot
+    fenwick_t tickets;      // Tickets per slot
+} lottery_rq_t;
+
+typedef struct {
+    sched_policy_t base;
+    int quantum;
+    rng_t rng;              // Shared by all queues
+    lottery_rq_t *rqs;
+} lottery_policy_t;
+
+static void lottery_destroy(sched_policy_t *p) {
+    lottery_policy_t *lp = (lottery_policy_t *)p;
+    for (int q = 0; q < p->nr_queues && lp->rqs; q++) {
+        arena_release(p->arena, lp->rqs[q].jobs);
+        fenwick_free(&lp->rqs[q].tickets);
+    }
+    arena_release(p->arena, lp->rqs);
+    arena_release(p->arena, lp);
+}
+
+static void lottery_enqueue(sched_policy_t *p, int q, int idx) {
+    lottery_rq_t *rq = &((lottery_policy_t *)p)->rqs[q];
+
+    if (rq->size == rq->tickets.capacity) {
+        int *jobs = arena_realloc(p->arena, rq->jobs, sizeof(int) * rq->size, sizeof(int) * 2 * rq->size);
+        if (jobs) rq->jobs = jobs;
+        if (!jobs || fenwick_reserve(&rq->tickets, 2 * rq->size) != 0) {
+            p->failed = 1;
+            return;
+        }
+    }
+    rq->jobs[rq->size] = idx;
+    fenwick_add(&rq->tickets, rq->size++, tickets_of(p->t, idx));
+}
+
+static int lottery_pick_next(sched_policy_t *p, int q) {
+    lottery_policy_t *lp = (lottery_policy_t *)p;
+    lottery_rq_t *rq = &lp->rqs[q];
+    int slot = fenwick_find(&rq->tickets, (long long)rng_below(&lp->rng, fenwick_total(&rq->tickets)));
+    int idx = rq->jobs[slot];
+    int last = --rq->size;
+
+    fenwick_add(&rq->tickets, slot, -tickets_of(p->t, idx));
+    if (slot != last) {
+        int moved = rq->jobs[last];
+        fenwick_add(&rq->tickets, last, -tickets_of(p->t, moved));
+        fenwick_add(&rq->tickets, slot, tickets_of(p->t, moved));
+        rq->jobs[slot] = moved;
+    }
+    return idx;
+}
+
+// Takes the last slots, so no hole needs filling
+static void lottery_migrate(sched_policy_t *p, int from, int to, int count) {
+    lottery_rq_t *rq = &((lottery_policy_t *)p)->rqs[from];
+    for (int k = 0; k < count; k++) {
+        int idx = rq->jobs[--rq->size];
+        fenwick_add(&rq->tickets, rq->size, -tickets_of(p->t, idx));
+        lottery_enqueue(p, to, idx);
+    }
+}
+
+static int lottery_slice(const sched_policy_t *p, int idx) {
+    (void)idx;
+    return ((const lottery_policy_t *)p)->quantum;
+}
+
+static void lottery_on_tick_expiry(sched_policy_t *p, int q, int idx, int ran) {
+    (void)ran;
+    lottery_enqueue(p, q, idx);
+}
+
+// Slots in order, plus the generator state
+static int lottery_capture(const sched_policy_t *p, int q, sim_session_t *s, checkpoint_t *cp) {
+    const lottery_policy_t *lp = (const lottery_policy_t *)p;
+    const lottery_rq_t *rq = &lp->rqs[q];
+
+    memcpy(cp->rng, lp->rng.s, sizeof(cp->rng));
+    for (int slot = 0; slot < rq->size; slot++) {
+        checkpoint_entry_t e = {0};
+        e.idx = rq->jobs[slot];
+        e.remaining_time = p->t->remaining_time[e.idx];
+        e.start_time = p->t->start_time[e.idx];
+        if (checkpoint_add(s, cp, &e) != 0) return -1;
+    }
+    return 0;
+}
+
+static void lottery_restore(sched_policy_t *p, int q, const sim_session_t *s, const checkpoint_t *cp) {
+    lottery_policy_t *lp = (lottery_policy_t *)p;
+
+    memcpy(lp->rng.s, cp->rng, sizeof(cp->rng));
+    for (int k = 0; k < cp->entry_count; k++) {
+        const checkpoint_entry_t *e = &s->entries[cp->first_entry + k];
+        p->t->remaining_time[e->idx] = e->remaining_time;
+        p->t->start_time[e->idx] = e->start_time;
+        lottery_enqueue(p, q, e->idx);
+    }
+}
+
+static const sched_policy_ops_t lottery_ops = {
+    .name = "Lottery",
+    .destroy = lottery_destroy,
+    .enqueue = lottery_enqueue,
+    .pick_next = lottery_pick_next,
+    .slice = lottery_slice,
+    .on_tick_expiry = lottery_on_tick_expiry,
+    .migrate = lottery_migrate,
+    .capture = lottery_capture,
+    .restore = lottery_restore,
+};
+
+static sched_policy_t *lottery_create(proc_table_t *t, int nr_queues, int quantum, uint64_t seed,
+                                      arena_t *arena) {
+    lottery_policy_t *lp = arena_calloc(arena, 1, sizeof(lottery_policy_t));
+    if (!lp) return NULL;
+
+    lp->base.ops = &lottery_ops;
+    lp->base.t = t;
+    lp->base.nr_queues = nr_queues;
+    lp->base.arena = arena;
+    lp->quantum = quantum < 1 ? 1 : quantum;
+    rng_seed(&lp->rng, seed);
+    lp->rqs = arena_calloc(arena, nr_queues, sizeof(lottery_rq_t));
+    if (!lp->rqs) {
+        lottery_destroy(&lp->base);
+        return NULL;
+    }
+
+    // A single queue can hold every job; per-core queues start small and grow
+    int capacity = nr_queues == 1 ? t->n : 16;
+    for (int q = 0; q < nr_queues; q++) {
+        lottery_rq_t *rq = &lp->rqs[q];
+        if (fenwick_init(&rq->tickets, capacity, arena) != 0 ||
+            !(rq->jobs = arena_alloc(arena, sizeof(int) * rq->tickets.capacity))) {
+            lottery_destroy(&lp->base);
+            return NULL;
+        }
+    }
+    return &lp->base;
+}
+
+// --- Stride ---
+// Each job's pass advances by its stride, STRIDE1 / tickets, per tick run;
+// the queue is a heap on pass. Like CFS's min_vruntime, each queue's global
+// pass only moves forward, new jobs start at it, and a job that changes
+// queue keeps its lag.
+
+#define STRIDE1 (1 << 20)
+
+typedef struct {
+    heap_policy_t heap;
+    int quantum;
+    long long *global_pass;     // Per queue
+    long long *pass;            // Per job
+    int *home;                  // Per job: queue it was last put on, -1 before its arrival
+} stride_policy_t;
+
+// Heap order: lowest pass, then lowest index
+static int stride_less(const void *ctx, int a, int b) {
+    const long long *pass = ctx;
+    if (pass[a] != pass[b]) return pass[a] < pass[b];
+    return a < b;
+}
+
+static long long stride_of(const proc_table_t *t, int idx) {
+    return STRIDE1 / tickets_of(t, idx) + 1;
+}
+
+static void stride_destroy(sched_policy_t *p) {
+    stride_policy_t *sp = (stride_policy_t *)p;
+    arena_release(p->arena, sp->global_pass);
+    arena_release(p->arena, sp->pass);
+    arena_release(p->arena, sp->home);
+    heap_destroy(p);
+}
+
+static void stride_reset(sched_policy_t *p, int idx) {
+    stride_policy_t *sp = (stride_policy_t *)p;
+    sp->pass[idx] = 0;
+    sp->home[idx] = -1;
+}
+
+static void stride_enqueue(sched_policy_t *p, int q, int idx) {
+    stride_policy_t *sp = (stride_policy_t *)p;
+    int from = sp->home[idx];
+
+    if (from < 0) sp->pass[idx] = sp->global_pass[q];
+    else if (from != q) sp->pass[idx] += sp->global_pass[q] - sp->global_pass[from];
+    sp->home[idx] = q;
+    heap_enqueue(p, q, idx);
+}
+
+static int stride_pick_next(sched_policy_t *p, int q) {
+    stride_policy_t *sp = (stride_policy_t *)p;
+    int idx = heap_pick_next(p, q);
+    if (sp->pass[idx] > sp->global_pass[q]) sp->global_pass[q] = sp->pass[idx];
+    return idx;
+}
+
+static int stride_slice(const sched_policy_t *p, int idx) {
+    (void)idx;
+    return ((const stride_policy_t *)p)->quantum;
+}
+
+static void stride_on_tick_expiry(sched_policy_t *p, int q, int idx, int ran) {
+    stride_policy_t *sp = (stride_policy_t *)p;
+    sp->pass[idx] += ran * stride_of(p->t, idx);
+    heap_enqueue(p, q, idx);
+}
+
+static int stride_capture(const sched_policy_t *p, int q, sim_session_t *s, checkpoint_t *cp) {
+    const stride_policy_t *sp = (const stride_policy_t *)p;
+    const pqueue_t *heap = &sp->heap.heaps[q];
+
+    cp->virtual_clock = sp->global_pass[q];
+    for (int k = 0; k < heap->size; k++) {
+        checkpoint_entry_t e = {0};
+        e.idx = heap->items[k];
+        e.remaining_time = p->t->remaining_time[e.idx];
+        e.start_time = p->t->start_time[e.idx];
+        e.virtual_time = sp->pass[e.idx];
+        if (checkpoint_add(s, cp, &e) != 0) return -1;
+    }
+    return 0;
+}
+
+static void stride_restore(sched_policy_t *p, int q, const sim_session_t *s, const checkpoint_t *cp) {
+    stride_policy_t *sp = (stride_policy_t *)p;
+
+    sp->global_pass[q] = cp->virtual_clock;
+    for (int k = 0; k < cp->entry_count; k++) {
+        const checkpoint_entry_t *e = &s->entries[cp->first_entry + k];
+        p->t->remaining_time[e->idx] = e->remaining_time;
+        p->t->start_time[e->idx] = e->start_time;
+        sp->pass[e->idx] = e->virtual_time;
+        sp->home[e->idx] = q;
+        heap_enqueue(p, q, e->idx);
+    }
+}
+
+static const sched_policy_ops_t stride_ops = {
+    .name = "Stride",
+    .destroy = stride_destroy,
+    .reset = stride_reset,
+    .enqueue = stride_enqueue,
+    .pick_next = stride_pick_next,
+    .slice = stride_slice,
+    .on_tick_expiry = stride_on_tick_expiry,
+    .migrate = heap_migrate,
+    .capture = stride_capture,
+    .restore = stride_restore,
+};
+
+static sched_policy_t *stride_create(proc_table_t *t, int nr_queues, int quantum, arena_t *arena) {
+    size_t jobs = t->n > 0 ? t->n : 1;
+    stride_policy_t *sp = arena_calloc(arena, 1, sizeof(stride_policy_t));
+    if (!sp) return NULL;
+
+    sp->heap.base.arena = arena;
+    sp->quantum = quantum < 1 ? 1 : quantum;
+    sp->global_pass = arena_calloc(arena, nr_queues, sizeof(long long));
+    sp->pass = arena_calloc(arena, jobs, sizeof(long long));
+    sp->home = arena_alloc(arena, sizeof(int) * jobs);
+    if (!sp->global_pass || !sp->pass || !sp->home ||
+        heap_init(&sp->heap, &stride_ops, t, nr_queues, stride_less, sp->pass, arena) != 0) {
+        stride_destroy(&sp->heap.base);
+        return NULL;
+    }
+    for (int i = 0; i < t->n; i++) sp->home[i] = -1;
+    return &sp->heap.base;
+}
+
+// ------------------------------------------------------
+// Factory
+// ------------------------------------------------------
+
+sched_policy_t *sched_policy_create(const sim_params_t *params, proc_table_t *t, int nr_queues,
+                                    arena_t *arena) {
+    if (nr_queues < 1) nr_queues = 1;
+
+    switch (params->policy) {
+        case SIM_FIFO: return list_create(&fifo_ops, t, nr_queues, 1, arena);
+        case SIM_SJF:  return heap_create(&sjf_ops, t, nr_queues, arena);
+        case SIM_STCF: return heap_create(&stcf_ops, t, nr_queues, arena);
+        case SIM_RR: {
+            sched_policy_t *p = list_create(&rr_ops, t, nr_queues, 1, arena);
+            if (p) ((list_policy_t *)p)->quantum = params->quantum < 1 ? 1 : params->quantum;
+            return p;
+        }
+        case SIM_MLFQ: {
+            const mlfq_config_t *mlfq = params->mlfq;
+            int levels = mlfq->num_queues;
+            if (levels < 1) levels = 1;
+            if (levels > MLFQ_MAX_QUEUES) levels = MLFQ_MAX_QUEUES;
+
+            sched_policy_t *p = list_create(&mlfq_ops, t, nr_queues, levels, arena);
+            if (!p) return NULL;
+            list_policy_t *lp = (list_policy_t *)p;
+            for (int level = 0; level < levels; level++) {
+                lp->quantums[level] = mlfq->quantums[level] < 1 ? 1 : mlfq->quantums[level];
+            }
+            p->boost_interval = mlfq->boost_interval;
+            return p;
+        }
+        case SIM_CFS: return cfs_create(t, nr_queues, params->cfs, arena);
+        case SIM_LOTTERY: return lottery_create(t, nr_queues, params->quantum, params->seed, arena);
+        case SIM_STRIDE: return stride_create(t, nr_queues, params->quantum, arena);
+        case SIM_PRIORITY:
+        case SIM_PRIORITY_PREEMPT: {
+            const sched_policy_ops_t *ops = params->policy == SIM_PRIORITY ? &prio_ops : &prio_preempt_ops;
+            sched_policy_t *p = list_create(ops, t, nr_queues, PRIORITY_LEVELS, arena);
+            if (p) p->boost_interval = params->aging_interval;
+            return p;
+        }
+    }
+    return NULL;
+}
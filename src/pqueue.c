@@ -0,0 +1,67 @@
+#include <stdlib.h>
+#include "pqueue.h"
+#include "instrument.h"
+
+int pqueue_init(pqueue_t *pq, int capacity, pqueue_less_fn less, const void *ctx, arena_t *arena) {
+    pq->arena = arena;
+    pq->items = arena_alloc(arena, sizeof(int) * (capacity > 0 ? capacity : 1));
+    pq->size = 0;
+    pq->capacity = capacity;
+    pq->less = less;
+    pq->ctx = ctx;
+    return pq->items ? 0 : -1;
+}
+
+void pqueue_free(pqueue_t *pq) {
+    arena_release(pq->arena, pq->items);
+    pq->items = NULL;
+    pq->size = 0;
+    pq->capacity = 0;
+}
+
+int pqueue_reserve(pqueue_t *pq, int capacity) {
+    if (capacity <= pq->capacity) return 0;
+
+    int *items = arena_realloc(pq->arena, pq->items, sizeof(int) * pq->capacity, sizeof(int) * capacity);
+    if (!items) return -1;
+    pq->items = items;
+    pq->capacity = capacity;
+    return 0;
+}
+
+// Caller guarantees size < capacity (each process is queued at most once)
+void pqueue_push(pqueue_t *pq, int item) {
+    int i = pq->size++;
+
+    // Sift up: move the hole towards the root while the parent is worse
+    while (i > 0) {
+        int parent = (i - 1) / 2;
+        SCHED_COUNT(queue_steps);
+        if (!pq->less(pq->ctx, item, pq->items[parent])) break;
+        pq->items[i] = pq->items[parent];
+        i = parent;
+    }
+    pq->items[i] = item;
+}
+
+int pqueue_pop(pqueue_t *pq) {
+    int top = pq->items[0];
+    int last = pq->items[--pq->size];
+    int i = 0;
+
+    // Sift down: move the hole towards the leaves while a child is better
+    while (1) {
+        int child = 2 * i + 1;
+        if (child >= pq->size) break;
+        SCHED_COUNT(queue_steps);
+        if (child + 1 < pq->size && pq->less(pq->ctx, pq->items[child + 1], pq->items[child])) {
+            child++;
+        }
+        if (!pq->less(pq->ctx, pq->items[child], last)) break;
+        pq->items[i] = pq->items[child];
+        i = child;
+    }
+    if (pq->size > 0) pq->items[i] = last;
+
+    return top;
+}
@@ -0,0 +1,143 @@
+#include <string.h>
+#include <stdbool.h>
+#include "scheduler.h"
+
+#define PROC_TABLE_COLUMNS 10
+
+int proc_table_init(proc_table_t *t, int n) {
+    size_t column = sizeof(int) * (size_t)(n > 0 ? n : 1);
+    // Round each column up to a 64-byte boundary so vector loads stay aligned
+    column = (column + 63) & ~(size_t)63;
+
+    memset(t, 0, sizeof(*t));
+    char *block = aligned_alloc(64, column * PROC_TABLE_COLUMNS);
+    if (!block) return -1;
+
+    int **columns[PROC_TABLE_COLUMNS] = {
+        &t->arrival_time, &t->burst_time, &t->remaining_time, &t->priority,
+        &t->pid, &t->start_time, &t->completion_time,
+        &t->turnaround_time, &t->waiting_time, &t->response_time
+    };
+    for (int c = 0; c < PROC_TABLE_COLUMNS; c++) {
+        *columns[c] = (int *)(block + c * column);
+    }
+    t->n = n;
+    t->block = block;
+    return 0;
+}
+
+void proc_table_free(proc_table_t *t) {
+    free(t->block);
+    memset(t, 0, sizeof(*t));
+}
+
+// Clears the simulation state columns
+static void proc_table_reset(proc_table_t *t) {
+    size_t bytes = sizeof(int) * t->n;
+    memcpy(t->remaining_time, t->burst_time, bytes);
+    memset(t->start_time, 0, bytes);
+    memset(t->completion_time, 0, bytes);
+    memset(t->turnaround_time, 0, bytes);
+    memset(t->waiting_time, 0, bytes);
+    memset(t->response_time, 0, bytes);
+}
+
+int proc_table_from_array(proc_table_t *t, const process_t *processes, int n) {
+    if (proc_table_init(t, n) != 0) return -1;
+    proc_table_load(t, processes);
+    return 0;
+}
+
+void proc_table_load(proc_table_t *t, const process_t *processes) {
+    for (int i = 0; i < t->n; i++) {
+        t->pid[i] = processes[i].pid;
+        t->arrival_time[i] = processes[i].arrival_time;
+        t->burst_time[i] = processes[i].burst_time;
+        t->priority[i] = processes[i].priority;
+        t->remaining_time[i] = processes[i].remaining_time;
+        t->start_time[i] = processes[i].start_time;
+        t->completion_time[i] = processes[i].completion_time;
+        t->turnaround_time[i] = processes[i].turnaround_time;
+        t->waiting_time[i] = processes[i].waiting_time;
+        t->response_time[i] = processes[i].response_time;
+    }
+}
+
+void proc_table_to_array(const proc_table_t *t, process_t *processes) {
+    for (int i = 0; i < t->n; i++) {
+        process_t *p = &processes[i];
+        p->pid = t->pid[i];
+        p->arrival_time = t->arrival_time[i];
+        p->burst_time = t->burst_time[i];
+        p->priority = t->priority[i];
+        p->remaining_time = t->remaining_time[i];
+        p->start_time = t->start_time[i];
+        p->completion_time = t->completion_time[i];
+        p->turnaround_time = t->turnaround_time[i];
+        p->waiting_time = t->waiting_time[i];
+        p->response_time = t->response_time[i];
+    }
+}
+
+void proc_table_copy_inputs(proc_table_t *dst, const proc_table_t *src) {
+    size_t bytes = sizeof(int) * src->n;
+    memcpy(dst->pid, src->pid, bytes);
+    memcpy(dst->arrival_time, src->arrival_time, bytes);
+    memcpy(dst->burst_time, src->burst_time, bytes);
+    memcpy(dst->priority, src->priority, bytes);
+    proc_table_reset(dst);
+}
+
+typedef struct {
+    int arrival_time;
+    int index;
+} arrival_key_t;
+
+static int compare_arrival(const void *a, const void *b) {
+    const arrival_key_t *x = a;
+    const arrival_key_t *y = b;
+    if (x->arrival_time != y->arrival_time) return x->arrival_time < y->arrival_time ? -1 : 1;
+    return x->index - y->index;
+}
+
+// Workloads are usually already in arrival order, so that case skips the sort.
+int *proc_table_arrival_order(const proc_table_t *t, arena_t *arena) {
+    int n = t->n;
+    int *order = arena_alloc(arena, sizeof(int) * (n > 0 ? n : 1));
+    bool sorted = true;
+
+    if (!order) return NULL;
+
+    for (int i = 0; i < n; i++) {
+        order[i] = i;
+        if (i > 0 && t->arrival_time[i] < t->arrival_time[i - 1]) sorted = false;
+    }
+    if (sorted) return order;
+
+    arrival_key_t *keys = arena_alloc(arena, sizeof(arrival_key_t) * n);
+    if (!keys) {
+        arena_release(arena, order);
+        return NULL;
+    }
+    for (int i = 0; i < n; i++) {
+        keys[i].arrival_time = t->arrival_time[i];
+        keys[i].index = i;
+    }
+    qsort(keys, n, sizeof(arrival_key_t), compare_arrival);
+    for (int i = 0; i < n; i++) {
+        order[i] = keys[i].index;
+    }
+    arena_release(arena, keys);
+    return order;
+}
+
+void proc_table_finish(proc_table_t *t, int idx, int completion_time, metrics_acc_t *acc) {
+    t->completion_time[idx] = completion_time;
+    t->turnaround_time[idx] = completion_time - t->arrival_time[idx];
+    t->waiting_time[idx] = t->turnaround_time[idx] - t->burst_time[idx];
+    t->response_time[idx] = t->start_time[idx] - t->arrival_time[idx];
+    if (acc) {
+        metrics_acc_add_times(acc, t->burst_time[idx], completion_time, t->turnaround_time[idx],
+                              t->waiting_time[idx], t->response_time[idx]);
+    }
+}
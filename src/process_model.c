@@ -0,0 +1,196 @@
+#include <string.h>
+#include "process_model.h"
+
+struct _ProcessModel {
+    GObject parent;
+    process_t *rows;        // malloc'd, so workload_load arrays can be adopted
+    int count;
+    int capacity;
+    gint stamp;             // Changes whenever existing iters become invalid
+};
+
+static void process_model_tree_model_init(GtkTreeModelIface *iface);
+
+G_DEFINE_TYPE_WITH_CODE(ProcessModel, process_model, G_TYPE_OBJECT,
+                        G_IMPLEMENT_INTERFACE(GTK_TYPE_TREE_MODEL, process_model_tree_model_init))
+
+// Iters carry the row index in user_data
+#define ITER_ROW(iter) GPOINTER_TO_INT((iter)->user_data)
+
+static gboolean set_iter(ProcessModel *model, GtkTreeIter *iter, int row) {
+    if (row < 0 || row >= model->count) {
+        iter->stamp = 0;
+        return FALSE;
+    }
+    iter->stamp = model->stamp;
+    iter->user_data = GINT_TO_POINTER(row);
+    return TRUE;
+}
+
+// ------------------------------------------------------
+// GtkTreeModel interface
+// ------------------------------------------------------
+
+static GtkTreeModelFlags model_get_flags(GtkTreeModel *tree_model) {
+    (void)tree_model;
+    return GTK_TREE_MODEL_LIST_ONLY;
+}
+
+static gint model_get_n_columns(GtkTreeModel *tree_model) {
+    (void)tree_model;
+    return PROCESS_MODEL_N_COLUMNS;
+}
+
+static GType model_get_column_type(GtkTreeModel *tree_model, gint column) {
+    (void)tree_model; (void)column;
+    return G_TYPE_INT;
+}
+
+static gboolean model_get_iter(GtkTreeModel *tree_model, GtkTreeIter *iter, GtkTreePath *path) {
+    if (gtk_tree_path_get_depth(path) != 1) return FALSE;
+    return set_iter(PROCESS_MODEL(tree_model), iter, gtk_tree_path_get_indices(path)[0]);
+}
+
+static GtkTreePath *model_get_path(GtkTreeModel *tree_model, GtkTreeIter *iter) {
+    (void)tree_model;
+    return gtk_tree_path_new_from_indices(ITER_ROW(iter), -1);
+}
+
+static void model_get_value(GtkTreeModel *tree_model, GtkTreeIter *iter, gint column, GValue *value) {
+    ProcessModel *model = PROCESS_MODEL(tree_model);
+    const process_t *p = &model->rows[ITER_ROW(iter)];
+
+    g_value_init(value, G_TYPE_INT);
+    switch (column) {
+        case PROCESS_COLUMN_PID:      g_value_set_int(value, p->pid); break;
+        case PROCESS_COLUMN_ARRIVAL:  g_value_set_int(value, p->arrival_time); break;
+        case PROCESS_COLUMN_BURST:    g_value_set_int(value, p->burst_time); break;
+        case PROCESS_COLUMN_PRIORITY: g_value_set_int(value, p->priority); break;
+        default: break;
+    }
+}
+
+static gboolean model_iter_next(GtkTreeModel *tree_model, GtkTreeIter *iter) {
+    return set_iter(PROCESS_MODEL(tree_model), iter, ITER_ROW(iter) + 1);
+}
+
+static gboolean model_iter_children(GtkTreeModel *tree_model, GtkTreeIter *iter, GtkTreeIter *parent) {
+    if (parent) return FALSE;
+    return set_iter(PROCESS_MODEL(tree_model), iter, 0);
+}
+
+static gboolean model_iter_has_child(GtkTreeModel *tree_model, GtkTreeIter *iter) {
+    (void)tree_model; (void)iter;
+    return FALSE;
+}
+
+static gint model_iter_n_children(GtkTreeModel *tree_model, GtkTreeIter *iter) {
+    return iter ? 0 : PROCESS_MODEL(tree_model)->count;
+}
+
+static gboolean model_iter_nth_child(GtkTreeModel *tree_model, GtkTreeIter *iter,
+                                     GtkTreeIter *parent, gint n) {
+    if (parent) return FALSE;
+    return set_iter(PROCESS_MODEL(tree_model), iter, n);
+}
+
+static gboolean model_iter_parent(GtkTreeModel *tree_model, GtkTreeIter *iter, GtkTreeIter *child) {
+    (void)tree_model; (void)iter; (void)child;
+    return FALSE;
+}
+
+static void process_model_tree_model_init(GtkTreeModelIface *iface) {
+    iface->get_flags = model_get_flags;
+    iface->get_n_columns = model_get_n_columns;
+    iface->get_column_type = model_get_column_type;
+    iface->get_iter = model_get_iter;
+    iface->get_path = model_get_path;
+    iface->get_value = model_get_value;
+    iface->iter_next = model_iter_next;
+    iface->iter_children = model_iter_children;
+    iface->iter_has_child = model_iter_has_child;
+    iface->iter_n_children = model_iter_n_children;
+    iface->iter_nth_child = model_iter_nth_child;
+    iface->iter_parent = model_iter_parent;
+}
+
+// ------------------------------------------------------
+// GObject
+// ------------------------------------------------------
+
+static void process_model_finalize(GObject *object) {
+    free(PROCESS_MODEL(object)->rows);
+    G_OBJECT_CLASS(process_model_parent_class)->finalize(object);
+}
+
+static void process_model_class_init(ProcessModelClass *klass) {
+    G_OBJECT_CLASS(klass)->finalize = process_model_finalize;
+}
+
+static void process_model_init(ProcessModel *model) {
+    model->rows = NULL;
+    model->count = 0;
+    model->capacity = 0;
+    model->stamp = g_random_int();
+}
+
+ProcessModel *process_model_new(void) {
+    return g_object_new(PROCESS_TYPE_MODEL, NULL);
+}
+
+// ------------------------------------------------------
+// Storage
+// ------------------------------------------------------
+
+process_t *process_model_rows(ProcessModel *model, int *count) {
+    *count = model->count;
+    return model->rows;
+}
+
+int process_model_append(ProcessModel *model, const process_t *process) {
+    // Grow geometrically so appends stay amortized O(1)
+    if (model->count == model->capacity) {
+        int grown = model->capacity ? model->capacity * 2 : 64;
+        process_t *rows = realloc(model->rows, sizeof(process_t) * grown);
+        if (!rows) return -1;
+        model->rows = rows;
+        model->capacity = grown;
+    }
+
+    int row = model->count++;
+    model->rows[row] = *process;
+
+    GtkTreeIter iter;
+    set_iter(model, &iter, row);
+    GtkTreePath *path = gtk_tree_path_new_from_indices(row, -1);
+    gtk_tree_model_row_inserted(GTK_TREE_MODEL(model), path, &iter);
+    gtk_tree_path_free(path);
+    return 0;
+}
+
+void process_model_replace(ProcessModel *model, process_t *rows, int count) {
+    free(model->rows);
+    model->rows = rows;
+    model->count = count;
+    model->capacity = count;
+    model->stamp++;
+}
+
+void process_model_set(ProcessModel *model, int row, int column, int value) {
+    if (row < 0 || row >= model->count) return;
+
+    process_t *p = &model->rows[row];
+    switch (column) {
+        case PROCESS_COLUMN_PID:      p->pid = value; break;
+        case PROCESS_COLUMN_ARRIVAL:  p->arrival_time = value; break;
+        case PROCESS_COLUMN_BURST:    p->burst_time = p->remaining_time = value; break;
+        case PROCESS_COLUMN_PRIORITY: p->priority = value; break;
+        default: return;
+    }
+
+    GtkTreeIter iter;
+    set_iter(model, &iter, row);
+    GtkTreePath *path = gtk_tree_path_new_from_indices(row, -1);
+    gtk_tree_model_row_changed(GTK_TREE_MODEL(model), path, &iter);
+    gtk_tree_path_free(path);
+}
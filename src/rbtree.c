@@ -0,0 +1,249 @@
+#include <stdlib.h>
+#include "rbtree.h"
+#include "instrument.h"
+
+// Classic sentinel-based red-black tree (CLRS). The sentinel's parent is
+// scratch space during erase; trees sharing the pool never interleave
+// operations, so that is safe.
+
+int rb_nodes_init(rb_nodes_t *nodes, int capacity, rb_less_fn less, const void *ctx, arena_t *arena) {
+    if (capacity < 0) capacity = 0;
+    size_t slots = (size_t)capacity + 1;
+
+    nodes->arena = arena;
+    nodes->left = arena_alloc(arena, sizeof(int) * 3 * slots);
+    nodes->red = arena_calloc(arena, slots, 1);
+    nodes->nil = capacity;
+    nodes->less = less;
+    nodes->ctx = ctx;
+    if (!nodes->left || !nodes->red) {
+        rb_nodes_free(nodes);
+        return -1;
+    }
+    nodes->right = nodes->left + slots;
+    nodes->parent = nodes->right + slots;
+    nodes->left[capacity] = nodes->right[capacity] = nodes->parent[capacity] = capacity;
+    return 0;
+}
+
+void rb_nodes_free(rb_nodes_t *nodes) {
+    arena_release(nodes->arena, nodes->left);
+    arena_release(nodes->arena, nodes->red);
+    nodes->left = nodes->right = nodes->parent = NULL;
+    nodes->red = NULL;
+}
+
+void rbtree_init(const rb_nodes_t *nodes, rbtree_t *tree) {
+    tree->root = nodes->nil;
+    tree->first = nodes->nil;
+    tree->size = 0;
+}
+
+// --- Rotations ---
+
+static void rotate_left(rb_nodes_t *nd, rbtree_t *tree, int x) {
+    int y = nd->right[x];
+    nd->right[x] = nd->left[y];
+    if (nd->left[y] != nd->nil) nd->parent[nd->left[y]] = x;
+    nd->parent[y] = nd->parent[x];
+    if (nd->parent[x] == nd->nil) tree->root = y;
+    else if (x == nd->left[nd->parent[x]]) nd->left[nd->parent[x]] = y;
+    else nd->right[nd->parent[x]] = y;
+    nd->left[y] = x;
+    nd->parent[x] = y;
+}
+
+static void rotate_right(rb_nodes_t *nd, rbtree_t *tree, int x) {
+    int y = nd->left[x];
+    nd->left[x] = nd->right[y];
+    if (nd->right[y] != nd->nil) nd->parent[nd->right[y]] = x;
+    nd->parent[y] = nd->parent[x];
+    if (nd->parent[x] == nd->nil) tree->root = y;
+    else if (x == nd->right[nd->parent[x]]) nd->right[nd->parent[x]] = y;
+    else nd->left[nd->parent[x]] = y;
+    nd->right[y] = x;
+    nd->parent[x] = y;
+}
+
+// --- Insert ---
+
+void rbtree_insert(rb_nodes_t *nd, rbtree_t *tree, int z) {
+    int y = nd->nil;
+    int x = tree->root;
+    int leftmost = 1;
+
+    while (x != nd->nil) {
+        SCHED_COUNT(queue_steps);
+        y = x;
+        if (nd->less(nd->ctx, z, x)) {
+            x = nd->left[x];
+        } else {
+            x = nd->right[x];
+            leftmost = 0;
+        }
+    }
+    nd->parent[z] = y;
+    if (y == nd->nil) tree->root = z;
+    else if (nd->less(nd->ctx, z, y)) nd->left[y] = z;
+    else nd->right[y] = z;
+    nd->left[z] = nd->right[z] = nd->nil;
+    nd->red[z] = 1;
+    if (leftmost) tree->first = z;
+    tree->size++;
+
+    while (nd->red[nd->parent[z]]) {
+        int p = nd->parent[z];
+        int g = nd->parent[p];
+        if (p == nd->left[g]) {
+            int uncle = nd->right[g];
+            if (nd->red[uncle]) {
+                nd->red[p] = nd->red[uncle] = 0;
+                nd->red[g] = 1;
+                z = g;
+            } else {
+                if (z == nd->right[p]) {
+                    z = p;
+                    rotate_left(nd, tree, z);
+                    p = nd->parent[z];
+                }
+                nd->red[p] = 0;
+                nd->red[g] = 1;
+                rotate_right(nd, tree, g);
+            }
+        } else {
+            int uncle = nd->left[g];
+            if (nd->red[uncle]) {
+                nd->red[p] = nd->red[uncle] = 0;
+                nd->red[g] = 1;
+                z = g;
+            } else {
+                if (z == nd->left[p]) {
+                    z = p;
+                    rotate_right(nd, tree, z);
+                    p = nd->parent[z];
+                }
+                nd->red[p] = 0;
+                nd->red[g] = 1;
+                rotate_left(nd, tree, g);
+            }
+        }
+    }
+    nd->red[tree->root] = 0;
+}
+
+// --- Erase ---
+
+static int subtree_min(const rb_nodes_t *nd, int x) {
+    while (nd->left[x] != nd->nil) x = nd->left[x];
+    return x;
+}
+
+int rbtree_next(const rb_nodes_t *nd, int x) {
+    if (nd->right[x] != nd->nil) return subtree_min(nd, nd->right[x]);
+    int p = nd->parent[x];
+    while (p != nd->nil && x == nd->right[p]) {
+        x = p;
+        p = nd->parent[p];
+    }
+    return p == nd->nil ? -1 : p;
+}
+
+static void transplant(rb_nodes_t *nd, rbtree_t *tree, int u, int v) {
+    if (nd->parent[u] == nd->nil) tree->root = v;
+    else if (u == nd->left[nd->parent[u]]) nd->left[nd->parent[u]] = v;
+    else nd->right[nd->parent[u]] = v;
+    nd->parent[v] = nd->parent[u];
+}
+
+static void erase_fixup(rb_nodes_t *nd, rbtree_t *tree, int x) {
+    while (x != tree->root && !nd->red[x]) {
+        int p = nd->parent[x];
+        if (x == nd->left[p]) {
+            int w = nd->right[p];
+            if (nd->red[w]) {
+                nd->red[w] = 0;
+                nd->red[p] = 1;
+                rotate_left(nd, tree, p);
+                w = nd->right[p];
+            }
+            if (!nd->red[nd->left[w]] && !nd->red[nd->right[w]]) {
+                nd->red[w] = 1;
+                x = p;
+            } else {
+                if (!nd->red[nd->right[w]]) {
+                    nd->red[nd->left[w]] = 0;
+                    nd->red[w] = 1;
+                    rotate_right(nd, tree, w);
+                    w = nd->right[p];
+                }
+                nd->red[w] = nd->red[p];
+                nd->red[p] = 0;
+                nd->red[nd->right[w]] = 0;
+                rotate_left(nd, tree, p);
+                x = tree->root;
+            }
+        } else {
+            int w = nd->left[p];
+            if (nd->red[w]) {
+                nd->red[w] = 0;
+                nd->red[p] = 1;
+                rotate_right(nd, tree, p);
+                w = nd->left[p];
+            }
+            if (!nd->red[nd->right[w]] && !nd->red[nd->left[w]]) {
+                nd->red[w] = 1;
+                x = p;
+            } else {
+                if (!nd->red[nd->left[w]]) {
+                    nd->red[nd->right[w]] = 0;
+                    nd->red[w] = 1;
+                    rotate_left(nd, tree, w);
+                    w = nd->left[p];
+                }
+                nd->red[w] = nd->red[p];
+                nd->red[p] = 0;
+                nd->red[nd->left[w]] = 0;
+                rotate_right(nd, tree, p);
+                x = tree->root;
+            }
+        }
+    }
+    nd->red[x] = 0;
+}
+
+void rbtree_erase(rb_nodes_t *nd, rbtree_t *tree, int z) {
+    int y = z;
+    int y_red = nd->red[y];
+    int x;
+
+    if (z == tree->first) {
+        int next = rbtree_next(nd, z);
+        tree->first = next < 0 ? nd->nil : next;
+    }
+
+    if (nd->left[z] == nd->nil) {
+        x = nd->right[z];
+        transplant(nd, tree, z, x);
+    } else if (nd->right[z] == nd->nil) {
+        x = nd->left[z];
+        transplant(nd, tree, z, x);
+    } else {
+        y = subtree_min(nd, nd->right[z]);
+        y_red = nd->red[y];
+        x = nd->right[y];
+        if (nd->parent[y] == z) {
+            nd->parent[x] = y;
+        } else {
+            transplant(nd, tree, y, x);
+            nd->right[y] = nd->right[z];
+            nd->parent[nd->right[y]] = y;
+        }
+        transplant(nd, tree, z, y);
+        nd->left[y] = nd->left[z];
+        nd->parent[nd->left[y]] = y;
+        nd->red[y] = nd->red[z];
+    }
+    tree->size--;
+
+    if (!y_red) erase_fixup(nd, tree, x);
+}
@@ -0,0 +1,197 @@
+#include <string.h>
+#include <math.h>
+#include "replicate.h"
+#include "policy.h"
+#include "threadpool.h"
+#include "scratch.h"
+#include "rng.h"
+
+#define METRICS_FIELD(name, member) {name, offsetof(metrics_t, member)}
+
+const metrics_field_t metrics_fields[METRICS_FIELD_COUNT] = {
+    METRICS_FIELD("avg_turnaround_time", avg_turnaround_time),
+    METRICS_FIELD("avg_waiting_time", avg_waiting_time),
+    METRICS_FIELD("avg_response_time", avg_response_time),
+    METRICS_FIELD("cpu_utilization", cpu_utilization),
+    METRICS_FIELD("throughput", throughput),
+    METRICS_FIELD("fairness_index", fairness_index),
+    METRICS_FIELD("turnaround_p50", turnaround.p50),
+    METRICS_FIELD("turnaround_p95", turnaround.p95),
+    METRICS_FIELD("turnaround_p99", turnaround.p99),
+    METRICS_FIELD("turnaround_max", turnaround.max),
+    METRICS_FIELD("waiting_p50", waiting.p50),
+    METRICS_FIELD("waiting_p95", waiting.p95),
+    METRICS_FIELD("waiting_p99", waiting.p99),
+    METRICS_FIELD("waiting_max", waiting.max),
+    METRICS_FIELD("response_p50", response.p50),
+    METRICS_FIELD("response_p95", response.p95),
+    METRICS_FIELD("response_p99", response.p99),
+    METRICS_FIELD("response_max", response.max),
+};
+
+// Per-worker state, reused for every replication the worker runs
+typedef struct {
+    process_t *workload;
+    proc_table_t inputs;        // This replication's workload
+    worker_scratch_t scratch;   // Each policy runs on a copy of 'inputs' here
+} replicate_worker_t;
+
+typedef struct {
+    const replicate_spec_t *spec;
+    replicate_worker_t *workers;
+    metrics_t *metrics;     // [replication][policy]
+    char *ok;               // Same layout: the run completed
+    const char *names[SIM_POLICY_COUNT];
+} replicate_job_t;
+
+static int default_quantums[] = {2, 4, 8};
+static mlfq_config_t default_mlfq = {3, default_quantums, 10};
+
+void replicate_default_spec(replicate_spec_t *spec) {
+    memset(spec, 0, sizeof(*spec));
+    workload_default_spec(&spec->workload, 1000, 0);
+    spec->replications = 30;
+    spec->seed = 1;
+    spec->params.quantum = 3;
+    spec->params.mlfq = &default_mlfq;
+    spec->threads = 0;
+}
+
+static void run_replication(void *ctx, int worker, size_t task) {
+    replicate_job_t *job = ctx;
+    replicate_worker_t *w = &job->workers[worker];
+    const replicate_spec_t *spec = job->spec;
+
+    // Both seeds depend only on the master seed and the replication index
+    uint64_t stream = spec->seed + task * 0xD1B54A32D192ED03ULL;
+    workload_spec_t ws = spec->workload;
+    ws.seed = rng_splitmix64(&stream);
+    sim_params_t params = spec->params;
+    params.seed = rng_splitmix64(&stream);
+
+    workload_generate(&ws, w->workload);
+    proc_table_load(&w->inputs, w->workload);
+
+    worker_scratch_t *s = &w->scratch;
+    for (int p = 0; p < SIM_POLICY_COUNT; p++) {
+        size_t slot = task * SIM_POLICY_COUNT + p;
+
+        params.policy = (sim_policy_t)p;
+        proc_table_copy_inputs(&s->table, &w->inputs);
+        metrics_acc_init(&s->acc);
+        long events = schedule_params_table(&params, &s->table, &s->arena, &s->timeline, &s->acc);
+        if (events >= 0) metrics_acc_finish(&s->acc, 0, &job->metrics[slot]);
+        job->ok[slot] = events >= 0;
+    }
+}
+
+// Two-sided 95% quantile of Student's t with 'df' degrees of freedom: exact
+// to three decimals up to 30, a Cornish-Fisher expansion of the normal beyond
+static double t_quantile_975(int df) {
+    static const double table[30] = {
+        12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+        2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+        2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042,
+    };
+    if (df <= 30) return table[df - 1];
+
+    const double z = 1.959964;
+    double z3 = z * z * z;
+    return z + (z3 + z) / (4.0 * df) + (5 * z3 * z * z + 16 * z3 + 3 * z) / (96.0 * df * df);
+}
+
+static double field(const metrics_t *m, size_t offset) {
+    return *(const double *)((const char *)m + offset);
+}
+
+// Mean and CI of each field over the completed runs, in replication order
+static void summarize(const replicate_job_t *job, int p, replicate_result_t *r) {
+    int k = job->spec->replications;
+    int count = 0;
+    for (int i = 0; i < k; i++) count += job->ok[(size_t)i * SIM_POLICY_COUNT + p];
+
+    memset(r, 0, sizeof(*r));
+    r->policy = (sim_policy_t)p;
+    r->name = job->names[p];
+    r->replications = count;
+    if (count == 0) return;
+
+    for (int f = 0; f < METRICS_FIELD_COUNT; f++) {
+        size_t offset = metrics_fields[f].offset;
+        double sum = 0, sq = 0;
+
+        for (int i = 0; i < k; i++) {
+            size_t slot = (size_t)i * SIM_POLICY_COUNT + p;
+            if (job->ok[slot]) sum += field(&job->metrics[slot], offset);
+        }
+        double mean = sum / count;
+        for (int i = 0; i < k; i++) {
+            size_t slot = (size_t)i * SIM_POLICY_COUNT + p;
+            if (job->ok[slot]) {
+                double d = field(&job->metrics[slot], offset) - mean;
+                sq += d * d;
+            }
+        }
+
+        double half = 0;
+        if (count > 1) half = t_quantile_975(count - 1) * sqrt(sq / (count - 1) / count);
+        *(double *)((char *)&r->mean + offset) = mean;
+        *(double *)((char *)&r->half_width + offset) = half;
+    }
+}
+
+int replicate_run(const replicate_spec_t *spec, replicate_result_t *results) {
+    int k = spec->replications > 0 ? spec->replications : 0;
+    int n = spec->workload.n > 0 ? spec->workload.n : 0;
+    size_t slots = (size_t)k * SIM_POLICY_COUNT;
+
+    int workers = spec->threads > 0 ? spec->threads : pool_default_workers();
+    if (workers > k) workers = k > 0 ? k : 1;
+
+    replicate_job_t job = {
+        .spec = spec,
+        .workers = calloc(workers, sizeof(replicate_worker_t)),
+        .metrics = malloc(sizeof(metrics_t) * (slots > 0 ? slots : 1)),
+        .ok = calloc(slots > 0 ? slots : 1, 1),
+    };
+    int ok = job.workers && job.metrics && job.ok;
+    for (int w = 0; ok && w < workers; w++) {
+        replicate_worker_t *rw = &job.workers[w];
+        worker_scratch_init(&rw->scratch);
+        rw->workload = malloc(sizeof(process_t) * (n > 0 ? n : 1));
+        if (!rw->workload || proc_table_init(&rw->inputs, n) != 0 ||
+            worker_scratch_table(&rw->scratch, n) != 0) {
+            ok = 0;
+        }
+    }
+
+    // Policy names, from a throwaway instance of each
+    proc_table_t empty;
+    if (ok && proc_table_init(&empty, 0) == 0) {
+        for (int p = 0; p < SIM_POLICY_COUNT; p++) {
+            sim_params_t params = spec->params;
+            params.policy = (sim_policy_t)p;
+            sched_policy_t *policy = sched_policy_create(&params, &empty, 1, NULL);
+            job.names[p] = policy ? policy->ops->name : "?";
+            sched_policy_destroy(policy);
+        }
+        proc_table_free(&empty);
+    } else {
+        ok = 0;
+    }
+
+    if (ok) ok = pool_run(workers, k, run_replication, &job) >= 0;
+    if (ok) {
+        for (int p = 0; p < SIM_POLICY_COUNT; p++) summarize(&job, p, &results[p]);
+    }
+
+    for (int w = 0; job.workers && w < workers; w++) {
+        free(job.workers[w].workload);
+        proc_table_free(&job.workers[w].inputs);
+        worker_scratch_free(&job.workers[w].scratch);
+    }
+    free(job.workers);
+    free(job.metrics);
+    free(job.ok);
+    return ok ? 0 : -1;
+}
@@ -1,13 +1,138 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <pthread.h>
+#include <errno.h>
+#include <limits.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
 #include "scheduler.h"
+#include "workload.h"
+#include "sweep.h"
+#include "smp.h"
+#include "replicate.h"
+#include "instrument.h"
+#include "trace.h"
+#include "online.h"
 
-#define MAX_TIMELINE 1000
+// Headless batch runner: loads a workload file and runs every algorithm on
+// its own worker thread, each on a private copy of the process array.
 
-// Helper to reset process states between algorithms
-void reset_processes(process_t *p, int n) {
-    // Workload 1 Hardcoded values for reset
+typedef enum {
+    ALGO_FIFO,
+    ALGO_SJF,
+    ALGO_STCF,
+    ALGO_RR,
+    ALGO_MLFQ,
+    ALGO_CFS,
+    ALGO_LOTTERY,
+    ALGO_STRIDE,
+    ALGO_PRIORITY,
+    ALGO_PRIORITY_PREEMPT,
+    ALGO_COUNT
+} algorithm_t;
+
+static const char *algo_names[ALGO_COUNT] = {
+    "FIFO", "SJF", "STCF", "Round Robin", "MLFQ", "CFS", "Lottery", "Stride", "Priority",
+    "Priority (P)"
+};
+
+// Trace file names under --trace
+static const char *algo_slugs[ALGO_COUNT] = {
+    "fifo", "sjf", "stcf", "rr", "mlfq", "cfs", "lottery", "stride", "priority", "priority-p"
+};
+
+// Per-thread job: inputs are shared read-only, everything else is private
+typedef struct {
+    algorithm_t algo;
+    const process_t *workload;  // Shared, never written
+    int n;
+    int quantum;                // Round Robin time quantum
+    mlfq_config_t *mlfq;        // MLFQ configuration
+    const cfs_config_t *cfs;    // CFS configuration
+    uint64_t seed;              // Lottery seed
+    int aging_interval;         // Priority aging, 0 for none
+    const smp_config_t *smp;    // Multi-core run, NULL for the single-CPU engines
+    const char *trace_dir;      // Write the timeline as a trace here, or NULL
+    int trace_failed;           // The trace could not be written
+    metrics_t metrics;          // Result
+    smp_stats_t stats;          // Multi-core results (core_utilization is owned)
+    long events;                // Timeline events, -1 on failure
+#ifdef SCHED_INSTRUMENT
+    sched_counters_t counters;  // The run's instrumentation counters
+#endif
+} job_t;
+
+static void *run_job(void *arg) {
+    job_t *job = arg;
+    timeline_t timeline;
+    metrics_acc_t acc;
+    proc_table_t table;
+
+    job->events = -1;
+    if (proc_table_from_array(&table, job->workload, job->n) != 0) return NULL;
+    timeline_init(&timeline);
+    metrics_acc_init(&acc);
+
+    // The trace is written as the run goes, one timeline chunk at a time
+    trace_writer_t trace;
+    int tracing = 0;
+    if (job->trace_dir) {
+        char trace_path[4096];
+        snprintf(trace_path, sizeof(trace_path), "%s/%s.trace", job->trace_dir, algo_slugs[job->algo]);
+        tracing = trace_writer_open(&trace, trace_path) == 0;
+        job->trace_failed = !tracing;
+        if (tracing) timeline_observe(&timeline, trace_writer_observer, &trace);
+    }
+
+    if (job->smp) {
+        sim_params_t params = {(sim_policy_t)job->algo, job->quantum, job->mlfq, job->cfs, job->seed,
+                              job->aging_interval};
+        job->events = schedule_smp_table(&table, &params, job->smp, NULL, &timeline, &acc, &job->stats);
+    } else {
+        switch (job->algo) {
+            case ALGO_FIFO: job->events = schedule_fifo_table(&table, &timeline, &acc); break;
+            case ALGO_SJF:  job->events = schedule_sjf_table(&table, &timeline, &acc); break;
+            case ALGO_STCF: job->events = schedule_stcf_table(&table, &timeline, &acc); break;
+            case ALGO_RR:   job->events = schedule_rr_table(&table, job->quantum, &timeline, &acc); break;
+            case ALGO_MLFQ: job->events = schedule_mlfq_table(&table, job->mlfq, &timeline, &acc); break;
+            case ALGO_CFS:  job->events = schedule_cfs_table(&table, job->cfs, &timeline, &acc); break;
+            case ALGO_LOTTERY:
+                job->events = schedule_lottery_table(&table, job->quantum, job->seed, &timeline, &acc);
+                break;
+            case ALGO_STRIDE: job->events = schedule_stride_table(&table, job->quantum, &timeline, &acc); break;
+            case ALGO_PRIORITY:
+            case ALGO_PRIORITY_PREEMPT:
+                job->events = schedule_priority_table(&table, job->algo == ALGO_PRIORITY_PREEMPT,
+                                                      job->aging_interval, &timeline, &acc);
+                break;
+            default: break;
+        }
+    }
+
+#ifdef SCHED_INSTRUMENT
+    job->counters = sched_counters;
+#endif
+
+    if (tracing) {
+        trace_writer_sync(&trace, &timeline, 1);
+        if (trace_writer_close(&trace) != 0) job->trace_failed = 1;
+    }
+
+    // Metrics were accumulated as processes completed
+    if (job->events >= 0) metrics_acc_finish(&acc, 0, &job->metrics);
+    if (job->events >= 0 && job->smp) job->metrics.cpu_utilization = job->stats.utilization;
+
+    timeline_free(&timeline);
+    proc_table_free(&table);
+    return NULL;
+}
+
+// The original "Workload 1" from docs/report.txt, used when no file is given
+static int default_workload(process_t **out) {
     // PID, Arrival, Burst, Priority
     int data[3][4] = {
         {1, 0, 5, 1},
@@ -15,79 +140,855 @@ void reset_processes(process_t *p, int n) {
         {3, 2, 8, 1}
     };
 
-    for(int i=0; i<n; i++) {
+    process_t *p = malloc(sizeof(process_t) * 3);
+    if (!p) return -1;
+    for (int i = 0; i < 3; i++) {
         p[i].pid = data[i][0];
         p[i].arrival_time = data[i][1];
         p[i].burst_time = data[i][2];
         p[i].priority = data[i][3];
-        p[i].remaining_time = p[i].burst_time;
-        p[i].start_time = 0;
-        p[i].completion_time = 0;
-        p[i].turnaround_time = 0;
-        p[i].waiting_time = 0;
-        p[i].response_time = 0;
-    }
-}
-
-void print_metrics(const char *algo_name, metrics_t *m) {
-    printf("\n=== %s Results ===\n", algo_name);
-    printf("Avg Turnaround: %.2f\n", m->avg_turnaround_time);
-    printf("Avg Waiting:    %.2f\n", m->avg_waiting_time);
-    printf("Avg Response:   %.2f\n", m->avg_response_time);
-    printf("Throughput:     %.2f\n", m->throughput);
-    printf("Fairness Idx:   %.2f\n", m->fairness_index);
-}
-
-int main() {
-    printf("Starting Scheduler Simulation CLI Test...\n");
-
-    int n = 3;
-    process_t processes[MAX_PROCESSES];
-    timeline_event_t timeline[MAX_TIMELINE];
-    metrics_t metrics;
-
-    // --- 1. FIFO ---
-    reset_processes(processes, n);
-    schedule_fifo(processes, n, timeline);
-    calculate_metrics(processes, n, processes[n-1].completion_time, &metrics);
-    print_metrics("FIFO", &metrics);
-
-    // --- 2. SJF ---
-    reset_processes(processes, n);
-    schedule_sjf(processes, n, timeline);
-    int max_time = 0;
-    for(int i=0; i<n; i++) if(processes[i].completion_time > max_time) max_time = processes[i].completion_time;
-    calculate_metrics(processes, n, max_time, &metrics);
-    print_metrics("SJF", &metrics);
-
-    // --- 3. STCF ---
-    reset_processes(processes, n);
-    schedule_stcf(processes, n, timeline);
-    max_time = 0;
-    for(int i=0; i<n; i++) if(processes[i].completion_time > max_time) max_time = processes[i].completion_time;
-    calculate_metrics(processes, n, max_time, &metrics);
-    print_metrics("STCF", &metrics);
-
-    // --- 4. Round Robin (q=3) ---
-    reset_processes(processes, n);
-    schedule_rr(processes, n, 3, timeline);
-    max_time = 0;
-    for(int i=0; i<n; i++) if(processes[i].completion_time > max_time) max_time = processes[i].completion_time;
-    calculate_metrics(processes, n, max_time, &metrics);
-    print_metrics("Round Robin (Q=3)", &metrics);
-
-    // --- 5. MLFQ ---
-    reset_processes(processes, n);
-    mlfq_config_t config;
-    config.num_queues = 3;
+    }
+    workload_reset(p, 3);
+    *out = p;
+    return 3;
+}
+
+static void print_table(const char *source, int n, job_t *jobs) {
+    printf("Workload: %s (%d processes)\n\n", source, n);
+    printf("%-12s %10s %10s %10s %9s %11s %9s %10s\n",
+           "Algorithm", "Avg TAT", "Avg Wait", "Avg Resp", "CPU %", "Throughput", "Fairness", "Events");
+    for (int a = 0; a < ALGO_COUNT; a++) {
+        metrics_t *m = &jobs[a].metrics;
+        if (jobs[a].events < 0) {
+            printf("%-12s %10s\n", algo_names[a], "failed");
+            continue;
+        }
+        printf("%-12s %10.2f %10.2f %10.2f %9.1f %11.4f %9.3f %10ld\n",
+               algo_names[a], m->avg_turnaround_time, m->avg_waiting_time,
+               m->avg_response_time, m->cpu_utilization, m->throughput,
+               m->fairness_index, jobs[a].events);
+    }
+
+    printf("\n%-12s %25s %25s %25s\n", "", "Turnaround p50/p95/p99/max",
+           "Waiting p50/p95/p99/max", "Response p50/p95/p99/max");
+    for (int a = 0; a < ALGO_COUNT; a++) {
+        if (jobs[a].events < 0) continue;
+        metrics_t *m = &jobs[a].metrics;
+        percentiles_t *tails[3] = {&m->turnaround, &m->waiting, &m->response};
+        printf("%-12s", algo_names[a]);
+        for (int k = 0; k < 3; k++) {
+            char cell[64];
+            snprintf(cell, sizeof(cell), "%.0f/%.0f/%.0f/%.0f",
+                     tails[k]->p50, tails[k]->p95, tails[k]->p99, tails[k]->max);
+            printf(" %25s", cell);
+        }
+        printf("\n");
+    }
+}
+
+#ifdef SCHED_INSTRUMENT
+static uint64_t counter_value(const sched_counters_t *c, int field) {
+    return *(const uint64_t *)((const char *)c + sched_counter_fields[field].offset);
+}
+
+// Column headings, in sched_counter_fields order
+static const char *counter_headings[SCHED_COUNTER_FIELDS] = {
+    "Picks", "Switches", "Preempts", "Requeues", "Boosts", "Demotions", "Q steps", "Idle",
+    "Ready max", "Pick cyc", "Acct cyc"
+};
+
+static void print_counters_table(job_t *jobs) {
+    printf("\n%-12s", "Counters");
+    for (int f = 0; f < SCHED_COUNTER_FIELDS; f++) printf(" %11s", counter_headings[f]);
+    printf("\n");
+    for (int a = 0; a < ALGO_COUNT; a++) {
+        if (jobs[a].events < 0) continue;
+        printf("%-12s", algo_names[a]);
+        for (int f = 0; f < SCHED_COUNTER_FIELDS; f++) {
+            printf(" %11llu", (unsigned long long)counter_value(&jobs[a].counters, f));
+        }
+        printf("\n");
+    }
+}
+
+static void print_json_counters(const sched_counters_t *c) {
+    printf(", \"counters\": {");
+    for (int f = 0; f < SCHED_COUNTER_FIELDS; f++) {
+        printf("%s\"%s\": %llu", f ? ", " : "", sched_counter_fields[f].name,
+               (unsigned long long)counter_value(c, f));
+    }
+    printf("}");
+}
+#endif
+
+static void print_smp_table(const smp_config_t *smp, job_t *jobs) {
+    printf("\n%d cores, %s balancing\n", smp->cpus, smp_balance_name(smp->balance));
+    printf("%-12s %10s %10s %10s %10s %11s\n",
+           "Algorithm", "Makespan", "Core min %", "Core avg %", "Core max %", "Migrations");
+    for (int a = 0; a < ALGO_COUNT; a++) {
+        smp_stats_t *st = &jobs[a].stats;
+        if (jobs[a].events < 0) continue;
+        double lo = 100, hi = 0;
+        for (int c = 0; c < st->cpus; c++) {
+            if (st->core_utilization[c] < lo) lo = st->core_utilization[c];
+            if (st->core_utilization[c] > hi) hi = st->core_utilization[c];
+        }
+        printf("%-12s %10d %10.1f %10.1f %10.1f %11ld\n",
+               algo_names[a], st->makespan, lo, st->utilization, hi, st->migrations);
+    }
+}
+
+static void print_json_percentiles(const char *name, const percentiles_t *p) {
+    printf(", \"%s\": {\"p50\": %.1f, \"p95\": %.1f, \"p99\": %.1f, \"max\": %.0f}",
+           name, p->p50, p->p95, p->p99, p->max);
+}
+
+static void print_json_string(FILE *f, const char *s) {
+    fputc('"', f);
+    for (; *s; s++) {
+        if ((unsigned char)*s < 0x20) {
+            fprintf(f, "\\u%04x", (unsigned char)*s);
+            continue;
+        }
+        if (*s == '"' || *s == '\\') fputc('\\', f);
+        fputc(*s, f);
+    }
+    fputc('"', f);
+}
+
+static void print_json(const char *source, int n, const smp_config_t *smp, job_t *jobs) {
+    printf("{\n  \"workload\": ");
+    print_json_string(stdout, source);
+    printf(",\n  \"processes\": %d,", n);
+    if (smp) printf("\n  \"cpus\": %d,\n  \"balance\": \"%s\",", smp->cpus, smp_balance_name(smp->balance));
+    printf("\n  \"results\": [\n");
+    for (int a = 0; a < ALGO_COUNT; a++) {
+        metrics_t *m = &jobs[a].metrics;
+        printf("    {\"algorithm\": \"%s\", ", algo_names[a]);
+        if (jobs[a].events < 0) {
+            printf("\"error\": \"out of memory\"}");
+        } else {
+            printf("\"avg_turnaround_time\": %.6f, \"avg_waiting_time\": %.6f, "
+                   "\"avg_response_time\": %.6f, \"cpu_utilization\": %.6f, "
+                   "\"throughput\": %.6f, \"fairness_index\": %.6f, \"events\": %ld",
+                   m->avg_turnaround_time, m->avg_waiting_time, m->avg_response_time,
+                   m->cpu_utilization, m->throughput, m->fairness_index, jobs[a].events);
+            print_json_percentiles("turnaround", &m->turnaround);
+            print_json_percentiles("waiting", &m->waiting);
+            print_json_percentiles("response", &m->response);
+#ifdef SCHED_INSTRUMENT
+            if (!smp) print_json_counters(&jobs[a].counters);
+#endif
+            if (smp) {
+                const smp_stats_t *st = &jobs[a].stats;
+                printf(", \"makespan\": %d, \"migrations\": %ld, \"core_utilization\": [",
+                       st->makespan, st->migrations);
+                for (int c = 0; c < st->cpus; c++) {
+                    printf("%s%.3f", c ? ", " : "", st->core_utilization[c]);
+                }
+                printf("]");
+            }
+            printf("}");
+        }
+        printf("%s\n", a + 1 < ALGO_COUNT ? "," : "");
+    }
+    printf("  ]\n}\n");
+}
+
+static void print_sweep(const char *source, int n, sweep_result_t *results, long count, int json, int all) {
+    long front = 0;
+    for (long i = 0; i < count; i++) front += results[i].pareto;
+
+    if (json) {
+        printf("{\n  \"workload\": ");
+        print_json_string(stdout, source);
+        printf(",\n  \"processes\": %d,\n  \"configurations\": %ld,\n  \"pareto_size\": %ld,\n  \"results\": [\n",
+               n, count, front);
+    } else {
+        printf("Workload: %s (%d processes)\n", source, n);
+        printf("Swept %ld configurations, %ld on the turnaround/response Pareto front%s\n\n",
+               count, front, all ? " (marked *)" : "");
+        printf("  %-6s %7s %7s %7s %7s %10s %10s %10s\n",
+               "Policy", "Quantum", "Levels", "Factor", "Boost", "Avg TAT", "Avg Wait", "Avg Resp");
+    }
+
+    int first = 1;
+    for (long i = 0; i < count; i++) {
+        sweep_result_t *r = &results[i];
+        if (!all && !r->pareto) continue;
+        const char *policy = r->policy == SWEEP_RR ? "RR" : "MLFQ";
+
+        if (json) {
+            printf("%s    {\"policy\": \"%s\", \"quantum\": %d", first ? "" : ",\n", policy, r->quantum);
+            if (r->policy == SWEEP_MLFQ) {
+                printf(", \"levels\": %d, \"factor\": %d, \"boost_interval\": %d",
+                       r->levels, r->factor, r->boost_interval);
+            }
+            if (r->events < 0) {
+                printf(", \"error\": \"out of memory\"}");
+            } else {
+                printf(", \"avg_turnaround_time\": %.6f, \"avg_waiting_time\": %.6f, "
+                       "\"avg_response_time\": %.6f, \"pareto\": %s}",
+                       r->metrics.avg_turnaround_time, r->metrics.avg_waiting_time,
+                       r->metrics.avg_response_time, r->pareto ? "true" : "false");
+            }
+        } else if (r->events < 0) {
+            printf("  %-6s %7d %27s\n", policy, r->quantum, "failed");
+        } else if (r->policy == SWEEP_RR) {
+            printf("%c %-6s %7d %7s %7s %7s %10.2f %10.2f %10.2f\n", r->pareto ? '*' : ' ',
+                   policy, r->quantum, "-", "-", "-", r->metrics.avg_turnaround_time,
+                   r->metrics.avg_waiting_time, r->metrics.avg_response_time);
+        } else {
+            printf("%c %-6s %7d %7d %7d %7d %10.2f %10.2f %10.2f\n", r->pareto ? '*' : ' ',
+                   policy, r->quantum, r->levels, r->factor, r->boost_interval,
+                   r->metrics.avg_turnaround_time, r->metrics.avg_waiting_time,
+                   r->metrics.avg_response_time);
+        }
+        first = 0;
+    }
+
+    if (json) printf("\n  ]\n}\n");
+}
+
+static void print_replicate(const replicate_spec_t *spec, const replicate_result_t *results, int json) {
+    const workload_spec_t *w = &spec->workload;
+    const char *arrivals = w->arrivals == ARRIVAL_BURSTY ? "bursty" : "poisson";
+    const char *bursts = w->bursts == BURST_PARETO ? "pareto" : "exp";
+
+    if (json) {
+        printf("{\n  \"replications\": %d,\n  \"processes\": %d,\n  \"seed\": %llu,\n"
+               "  \"arrivals\": \"%s\",\n  \"arrival_rate\": %.6f,\n  \"bursts\": \"%s\",\n"
+               "  \"burst_mean\": %.6f,\n  \"results\": [\n",
+               spec->replications, w->n, (unsigned long long)spec->seed, arrivals, w->arrival_rate,
+               bursts, w->burst_mean);
+        for (int p = 0; p < SIM_POLICY_COUNT; p++) {
+            const replicate_result_t *r = &results[p];
+            printf("    {\"algorithm\": \"%s\", \"replications\": %d", r->name, r->replications);
+            for (int f = 0; f < METRICS_FIELD_COUNT; f++) {
+                size_t offset = metrics_fields[f].offset;
+                printf(", \"%s\": {\"mean\": %.6f, \"ci95\": %.6f}", metrics_fields[f].name,
+                       *(const double *)((const char *)&r->mean + offset),
+                       *(const double *)((const char *)&r->half_width + offset));
+            }
+            printf("}%s\n", p + 1 < SIM_POLICY_COUNT ? "," : "");
+        }
+        printf("  ]\n}\n");
+        return;
+    }
+
+    printf("%d replications of %d processes (%s arrivals at rate %.3f, %s bursts with mean %.1f), seed %llu\n",
+           spec->replications, w->n, arrivals, w->arrival_rate, bursts, w->burst_mean,
+           (unsigned long long)spec->seed);
+    printf("Mean +- 95%% confidence interval half-width\n\n");
+    printf("%-12s %17s %17s %17s %17s %15s\n",
+           "Algorithm", "Avg TAT", "Avg Wait", "Avg Resp", "p99 TAT", "Fairness");
+    for (int p = 0; p < SIM_POLICY_COUNT; p++) {
+        const replicate_result_t *r = &results[p];
+        const metrics_t *m = &r->mean;
+        const metrics_t *h = &r->half_width;
+        if (r->replications < spec->replications) {
+            printf("%-12s %s (%d of %d runs)\n", r->name, "failed", spec->replications - r->replications,
+                   spec->replications);
+            if (r->replications == 0) continue;
+        }
+        printf("%-12s %9.2f +- %-5.2f %9.2f +- %-5.2f %9.2f +- %-5.2f %9.1f +- %-5.1f %7.3f +- %-5.3f\n",
+               r->name, m->avg_turnaround_time, h->avg_turnaround_time, m->avg_waiting_time,
+               h->avg_waiting_time, m->avg_response_time, h->avg_response_time, m->turnaround.p99,
+               h->turnaround.p99, m->fairness_index, h->fairness_index);
+    }
+}
+
+// Summarizes a trace file read through its mapping. With a window, also
+// lists the events that overlap it, found through the seek index.
+static int print_replay(const char *path, const sweep_range_t *window) {
+    trace_t trace;
+    if (trace_open(path, &trace) != 0) return 1;
+
+    trace_cursor_t c;
+    timeline_event_t e;
+    long long busy = 0;
+    int cpus = 0;
+    trace_seek(&c, &trace, 0);
+    while (trace_next(&c, &e)) {
+        busy += e.duration;
+        if (e.cpu >= cpus) cpus = e.cpu + 1;
+    }
+
+    size_t bytes = trace.header->data_bytes;
+    printf("Trace: %s\n", path);
+    if (trace.count == 0) {
+        printf("  Events:      0 (an empty run)\n");
+    } else {
+        double per_event = (double)bytes / trace.count;
+        printf("  Events:      %zu (%zu bytes, %.2f bytes/event, %.1fx smaller than in memory)\n",
+               trace.count, bytes, per_event, sizeof(timeline_event_t) / per_event);
+        printf("  Time span:   0 - %d on %d core%s\n", trace.end_time, cpus, cpus == 1 ? "" : "s");
+    }
+    if (trace.end_time > 0) {
+        printf("  Utilization: %.2f%%\n", 100.0 * busy / ((double)trace.end_time * cpus));
+    }
+
+    if (window) {
+        printf("\nEvents overlapping [%d, %d):\n", window->min, window->max);
+        printf("  %10s %10s %10s %5s\n", "Start", "Duration", "PID", "CPU");
+        trace_seek(&c, &trace, trace_find(&trace, window->min));
+        while (trace_next_overlapping(&c, window->min, window->max, &e)) {
+            printf("  %10d %10d %10d %5d\n", e.time, e.duration, e.pid, e.cpu);
+        }
+    }
+
+    trace_close(&trace);
+    return 0;
+}
+
+// ------------------------------------------------------
+// Online mode
+// ------------------------------------------------------
+// Jobs come in one per line ("pid arrival burst [priority]", arrivals in
+// time order) and decisions go out as they become known:
+//   dispatch TIME PID DURATION   the job runs for up to DURATION
+//   preempt TIME PID RAN         it lost the CPU early, after RAN
+//   complete TIME PID
+// A line holding just "." says every arrival up to the latest one is in, so
+// a live producer gets the decisions at that time without sending the next
+// job first. End of input runs the remaining jobs to completion.
+
+// Reads lines straight from a descriptor, flushing 'out' before it would
+// block so a live producer sees every decision its input made possible
+typedef struct {
+    int fd;
+    FILE *out;
+    size_t start, end;
+    char buf[64 * 1024];
+} line_reader_t;
+
+static char *read_line(line_reader_t *r) {
+    for (;;) {
+        char *nl = memchr(r->buf + r->start, '\n', r->end - r->start);
+        if (nl || r->end - r->start == sizeof(r->buf) - 1) {
+            char *line = r->buf + r->start;
+            if (!nl) nl = r->buf + r->end;   // Overlong: hand it over as it is
+            *nl = '\0';
+            r->start = nl - r->buf + (nl < r->buf + r->end);
+            return line;
+        }
+
+        memmove(r->buf, r->buf + r->start, r->end - r->start);
+        r->end -= r->start;
+        r->start = 0;
+        fflush(r->out);
+
+        ssize_t got = read(r->fd, r->buf + r->end, sizeof(r->buf) - 1 - r->end);
+        if (got < 0 && errno == EINTR) continue;
+        if (got <= 0) {
+            if (r->end == 0) return NULL;
+            r->buf[r->end] = '\0';  // Last line without a newline
+            r->start = r->end;
+            return r->buf;
+        }
+        r->end += got;
+    }
+}
+
+static void emit_decision(void *ctx, const online_event_t *e) {
+    FILE *out = ctx;
+    switch (e->kind) {
+        case ONLINE_DISPATCH: fprintf(out, "dispatch %d %d %d\n", e->time, e->pid, e->duration); break;
+        case ONLINE_PREEMPT:  fprintf(out, "preempt %d %d %d\n", e->time, e->pid, e->duration); break;
+        case ONLINE_COMPLETE: fprintf(out, "complete %d %d\n", e->time, e->pid); break;
+    }
+}
+
+static void print_online_report(FILE *f, const char *source, const char *name,
+                                const online_report_t *r, int json) {
+    if (json) {
+        fprintf(f, "{\"source\": ");
+        print_json_string(f, source);
+        fprintf(f, ", \"algorithm\": \"%s\", \"processes\": %llu, "
+                   "\"completed\": %llu, \"decisions\": %llu,\n"
+                   " \"latency_ns\": {\"p50\": %.0f, \"p99\": %.0f, \"p999\": %.0f, \"max\": %.0f},\n"
+                   " \"decisions_per_sec\": %.0f, \"engine_decisions_per_sec\": %.0f",
+                name, (unsigned long long)r->jobs, (unsigned long long)r->completed,
+                (unsigned long long)r->decisions, r->latency_p50, r->latency_p99, r->latency_p999,
+                r->latency_max, r->decisions_per_sec, r->engine_decisions_per_sec);
+        for (int k = 0; k < METRICS_FIELD_COUNT; k++) {
+            fprintf(f, ", \"%s\": %.6f", metrics_fields[k].name,
+                    *(const double *)((const char *)&r->metrics + metrics_fields[k].offset));
+        }
+        fprintf(f, "}\n");
+    } else {
+        fprintf(f, "Online %s (%s): %llu processes, %llu completed, %llu decisions\n", name, source,
+                (unsigned long long)r->jobs, (unsigned long long)r->completed,
+                (unsigned long long)r->decisions);
+        fprintf(f, "  Decision latency: p50 %.0f ns, p99 %.0f ns, p99.9 %.0f ns, max %.0f ns\n",
+                r->latency_p50, r->latency_p99, r->latency_p999, r->latency_max);
+        fprintf(f, "  Sustained rate:   %.0f decisions/s (%.0f/s inside the scheduler)\n",
+                r->decisions_per_sec, r->engine_decisions_per_sec);
+        fprintf(f, "  Avg TAT %.2f | Avg Wait %.2f | Avg Resp %.2f | p99 TAT %.0f\n",
+                r->metrics.avg_turnaround_time, r->metrics.avg_waiting_time,
+                r->metrics.avg_response_time, r->metrics.turnaround.p99);
+    }
+    fflush(f);
+}
+
+// One stream, from the first line to end of input. Returns 0, or -1 if the
+// policy could not be built.
+static int run_online(int fd, FILE *out, FILE *report, const char *source, const sim_params_t *params,
+                      int capacity, int quiet, int json) {
+    online_t o;
+    if (online_init(&o, params, capacity, quiet ? NULL : emit_decision, out, NULL) != 0) {
+        fprintf(stderr, "Out of memory\n");
+        return -1;
+    }
+
+    static line_reader_t reader;
+    reader.fd = fd;
+    reader.out = out;
+    reader.start = reader.end = 0;
+
+    char *line;
+    int line_no = 0;
+    int last_arrival = -1;
+    while ((line = read_line(&reader))) {
+        line_no++;
+        while (*line == ' ' || *line == '\t' || *line == '\r') line++;
+        if (*line == '\0' || *line == '#') continue;
+        if (line[0] == '.' && (line[1] == '\0' || line[1] == '\r')) {
+            online_advance(&o, last_arrival);
+            continue;
+        }
+
+        workload_record_t job;
+        if (workload_parse_line(source, line_no, line, o.admitted > 0, &job) <= 0) continue;
+        if (job.arrival_time == INT_MAX) {
+            // INT_MAX is the end-of-input horizon
+            fprintf(stderr, "%s:%d: value out of range\n", source, line_no);
+            continue;
+        }
+        if (o.admitted == capacity) {
+            fprintf(stderr, "%s:%d: job limit (%d) reached, use --max-jobs\n", source, line_no, capacity);
+            continue;
+        }
+        if (online_submit(&o, job.pid, job.arrival_time, job.burst_time, job.priority) != 0) {
+            fprintf(stderr, "%s:%d: arrival %d is earlier than one already seen\n", source, line_no,
+                    job.arrival_time);
+            continue;
+        }
+        last_arrival = job.arrival_time;
+    }
+    online_advance(&o, INT_MAX);
+    fflush(out);
+
+    online_report_t r;
+    online_report(&o, &r);
+    print_online_report(report, source, o.p->ops->name, &r, json);
+    online_free(&o);
+    return 0;
+}
+
+// Serves one stream per connection on a Unix socket, until killed
+static int serve_online(const char *path, const sim_params_t *params, int capacity, int quiet,
+                        int json) {
+    struct sockaddr_un addr = {.sun_family = AF_UNIX};
+    if (strlen(path) >= sizeof(addr.sun_path)) {
+        fprintf(stderr, "%s: socket path too long\n", path);
+        return 1;
+    }
+    strcpy(addr.sun_path, path);
+
+    // Replace a socket left by an earlier run, but never any other file
+    struct stat st;
+    if (lstat(path, &st) == 0) {
+        if (!S_ISSOCK(st.st_mode)) {
+            fprintf(stderr, "%s: exists and is not a socket\n", path);
+            return 1;
+        }
+        unlink(path);
+    }
+
+    int server = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (server < 0) {
+        perror("socket");
+        return 1;
+    }
+    if (bind(server, (struct sockaddr *)&addr, sizeof(addr)) != 0 || listen(server, 8) != 0) {
+        perror(path);
+        close(server);
+        return 1;
+    }
+
+    // A client that hangs up must not take the daemon with it
+    signal(SIGPIPE, SIG_IGN);
+    fprintf(stderr, "Listening on %s\n", path);
+
+    for (;;) {
+        int client = accept(server, NULL, NULL);
+        if (client < 0) {
+            if (errno == EINTR) continue;
+            perror("accept");
+            break;
+        }
+        int out_fd = dup(client);
+        FILE *out = out_fd >= 0 ? fdopen(out_fd, "w") : NULL;
+        if (out) {
+            run_online(client, out, stdout, path, params, capacity, quiet, json);
+            fclose(out);
+        } else {
+            perror("fdopen");
+            if (out_fd >= 0) close(out_fd);
+        }
+        close(client);
+    }
+    close(server);
+    return 1;
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr,
+            "Usage: %s [--json] [--quantum N] [--cfs-latency N] [--cfs-granularity N]\n"
+            "          [--seed N] [--aging N] [--cpus N [--balance MODE]] [workload-file]\n"
+            "       %s --sweep [sweep options] [--json] [workload-file]\n"
+            "       %s --replicate K [replication options] [--json]\n"
+            "       %s --convert text-workload binary-workload\n"
+            "       %s --replay trace-file [--window START:END]\n"
+            "       %s --online POLICY [--socket PATH] [--max-jobs N] [--quiet] [--json]\n"
+            "  Runs FIFO, SJF, STCF, Round Robin, MLFQ, CFS, Lottery, Stride and static\n"
+            "  priority (non-preemptive and preemptive) in parallel and prints their\n"
+            "  metrics. Without a workload file the built-in 3-process workload is used.\n"
+            "  CFS reads priorities as nice values; --cfs-latency and --cfs-granularity set\n"
+            "  its sched_latency (default 24) and min_granularity (default 3).\n"
+            "  Lottery and Stride read priorities as ticket counts and use --quantum;\n"
+            "  --seed seeds the lottery draws (default 1).\n"
+            "  Priority runs the lowest priority value first; --aging N moves waiting jobs\n"
+            "  up one level every N ticks (default 0, no aging).\n"
+            "  --convert streams a text/CSV workload into the mmap-able binary format.\n"
+            "  --trace DIR writes each algorithm's timeline to DIR/<algorithm>.trace in\n"
+            "  the compact trace format while it runs; --replay summarizes a trace (and\n"
+            "  lists the events in --window) straight from the mapped file.\n"
+            "  --cpus simulates N cores, each with its own run queue. --balance picks how\n"
+            "  work moves between them: global (one shared queue), push (periodic push\n"
+            "  migration) or steal (idle cores steal half the longest queue, default).\n"
+            "\n"
+            "Online mode reads jobs as 'pid arrival burst [priority]' lines, in arrival\n"
+            "order, from stdin (or from each connection to --socket PATH) and writes the\n"
+            "policy's decisions as 'dispatch TIME PID DURATION', 'preempt TIME PID RAN'\n"
+            "and 'complete TIME PID' lines as soon as they are known. A '.' line says\n"
+            "every arrival up to the latest one is in. At end of input it reports\n"
+            "decision latency percentiles and decisions/s (to stderr for stdin).\n"
+            "POLICY is fifo, sjf, stcf, rr, mlfq, cfs, lottery, stride, priority or\n"
+            "priority-p; --quantum, --cfs-*, --seed and --aging apply. --max-jobs caps\n"
+            "the jobs per stream (default 1048576), --quiet skips the decisions.\n"
+            "\n"
+            "Sweep mode simulates every RR / MLFQ configuration in the given ranges and\n"
+            "prints the Pareto front of avg turnaround vs. avg response time.\n"
+            "Ranges are min:max[:step] or a single value; an empty range (e.g. 1:0) skips it.\n"
+            "  --rr R            RR quantum                      (default 1:20)\n"
+            "  --mlfq-levels R   MLFQ queue count                (default 2:4)\n"
+            "  --mlfq-quantum R  top-level MLFQ quantum          (default 1:8)\n"
+            "  --mlfq-factor R   quantum multiplier per level    (default 1:3)\n"
+            "  --mlfq-boost R    boost interval, 0 = never       (default 0:200:25)\n"
+            "  --threads N       worker threads                  (default: one per CPU)\n"
+            "  --all             print every configuration, not just the front\n"
+            "\n"
+            "Replication mode draws K seeded random workloads and runs every algorithm on\n"
+            "each, then prints the mean and 95%% confidence interval of each metric. The\n"
+            "results are identical for a given --seed whatever --threads is. --quantum,\n"
+            "--cfs-*, --aging and --threads apply as above.\n"
+            "  --jobs N          processes per workload          (default 1000)\n"
+            "  --rate R          mean arrivals per tick          (default 0.09)\n"
+            "  --arrivals D      poisson or bursty               (default poisson)\n"
+            "  --burst-mean M    mean burst length               (default 10)\n"
+            "  --bursts D        exp or pareto                   (default exp)\n",
+            prog, prog, prog, prog, prog, prog);
+}
+
+// Handles one sweep option; returns 1 if consumed, 0 if not a sweep option,
+// -1 on a malformed value
+static int parse_sweep_option(int argc, char *argv[], int *i, sweep_spec_t *spec) {
+    struct { const char *name; sweep_range_t *range; } options[] = {
+        {"--rr", &spec->rr_quantum},
+        {"--mlfq-levels", &spec->mlfq_levels},
+        {"--mlfq-quantum", &spec->mlfq_quantum},
+        {"--mlfq-factor", &spec->mlfq_factor},
+        {"--mlfq-boost", &spec->mlfq_boost},
+    };
+
+    if (strcmp(argv[*i], "--threads") == 0 && *i + 1 < argc) {
+        spec->threads = atoi(argv[++*i]);
+        return 1;
+    }
+    for (size_t k = 0; k < sizeof(options) / sizeof(options[0]); k++) {
+        if (strcmp(argv[*i], options[k].name) == 0 && *i + 1 < argc) {
+            if (sweep_parse_range(argv[++*i], options[k].range) != 0) {
+                fprintf(stderr, "Invalid range for %s: %s\n", options[k].name, argv[*i]);
+                return -1;
+            }
+            return 1;
+        }
+    }
+    return 0;
+}
+
+int main(int argc, char *argv[]) {
+    int json = 0;
+    int quantum = 3;
+    int sweep = 0;
+    int sweep_all = 0;
+    int replicate = 0;
+    const char *path = NULL;
+    sweep_spec_t spec;
+    smp_config_t smp;
+    int cpus = 0;
+    cfs_config_t cfs;
+    uint64_t seed = 1;
+    int aging_interval = 0;
+    const char *trace_dir = NULL;
+    const char *replay = NULL;
+    sweep_range_t window;
+    int has_window = 0;
+    int online = -1;
+    const char *socket_path = NULL;
+    int max_jobs = 1 << 20;
+    int quiet = 0;
+    replicate_spec_t rep;
+
+    replicate_default_spec(&rep);
+
+    sweep_default_spec(&spec);
+    smp_default_config(&smp, 1);
+    cfs_default_config(&cfs);
+
+    for (int i = 1; i < argc; i++) {
+        int consumed = parse_sweep_option(argc, argv, &i, &spec);
+        if (consumed < 0) return 2;
+        if (consumed > 0) continue;
+
+        if (strcmp(argv[i], "--json") == 0) {
+            json = 1;
+        } else if (strcmp(argv[i], "--sweep") == 0) {
+            sweep = 1;
+        } else if (strcmp(argv[i], "--all") == 0) {
+            sweep_all = 1;
+        } else if (strcmp(argv[i], "--convert") == 0 && i + 2 < argc) {
+            long long count = workload_convert(argv[i + 1], argv[i + 2]);
+            if (count < 0) return 1;
+            fprintf(stderr, "Wrote %lld processes to %s\n", count, argv[i + 2]);
+            return 0;
+        } else if (strcmp(argv[i], "--quantum") == 0 && i + 1 < argc) {
+            quantum = atoi(argv[++i]);
+            if (quantum < 1) {
+                fprintf(stderr, "Quantum must be at least 1\n");
+                return 2;
+            }
+        } else if (strcmp(argv[i], "--cfs-latency") == 0 && i + 1 < argc) {
+            cfs.sched_latency = atoi(argv[++i]);
+            if (cfs.sched_latency < 1) {
+                fprintf(stderr, "CFS latency must be at least 1\n");
+                return 2;
+            }
+        } else if (strcmp(argv[i], "--cfs-granularity") == 0 && i + 1 < argc) {
+            cfs.min_granularity = atoi(argv[++i]);
+            if (cfs.min_granularity < 1) {
+                fprintf(stderr, "CFS granularity must be at least 1\n");
+                return 2;
+            }
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            seed = strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--aging") == 0 && i + 1 < argc) {
+            aging_interval = atoi(argv[++i]);
+            if (aging_interval < 0) {
+                fprintf(stderr, "Aging interval must not be negative\n");
+                return 2;
+            }
+        } else if (strcmp(argv[i], "--replicate") == 0 && i + 1 < argc) {
+            replicate = 1;
+            rep.replications = atoi(argv[++i]);
+            if (rep.replications < 1) {
+                fprintf(stderr, "Replication count must be at least 1\n");
+                return 2;
+            }
+        } else if (strcmp(argv[i], "--jobs") == 0 && i + 1 < argc) {
+            rep.workload.n = atoi(argv[++i]);
+            if (rep.workload.n < 1) {
+                fprintf(stderr, "Job count must be at least 1\n");
+                return 2;
+            }
+        } else if (strcmp(argv[i], "--rate") == 0 && i + 1 < argc) {
+            rep.workload.arrival_rate = atof(argv[++i]);
+            if (!(rep.workload.arrival_rate > 0)) {
+                fprintf(stderr, "Arrival rate must be positive\n");
+                return 2;
+            }
+        } else if (strcmp(argv[i], "--burst-mean") == 0 && i + 1 < argc) {
+            rep.workload.burst_mean = atof(argv[++i]);
+            if (!(rep.workload.burst_mean > 0)) {
+                fprintf(stderr, "Mean burst must be positive\n");
+                return 2;
+            }
+        } else if (strcmp(argv[i], "--arrivals") == 0 && i + 1 < argc) {
+            const char *d = argv[++i];
+            if (strcmp(d, "poisson") == 0) rep.workload.arrivals = ARRIVAL_POISSON;
+            else if (strcmp(d, "bursty") == 0) rep.workload.arrivals = ARRIVAL_BURSTY;
+            else {
+                fprintf(stderr, "Unknown arrival distribution: %s\n", d);
+                return 2;
+            }
+        } else if (strcmp(argv[i], "--bursts") == 0 && i + 1 < argc) {
+            const char *d = argv[++i];
+            if (strcmp(d, "exp") == 0) rep.workload.bursts = BURST_EXPONENTIAL;
+            else if (strcmp(d, "pareto") == 0) rep.workload.bursts = BURST_PARETO;
+            else {
+                fprintf(stderr, "Unknown burst distribution: %s\n", d);
+                return 2;
+            }
+        } else if (strcmp(argv[i], "--cpus") == 0 && i + 1 < argc) {
+            cpus = atoi(argv[++i]);
+            if (cpus < 1 || cpus > SMP_MAX_CPUS) {
+                fprintf(stderr, "Core count must be between 1 and %d\n", SMP_MAX_CPUS);
+                return 2;
+            }
+        } else if (strcmp(argv[i], "--balance") == 0 && i + 1 < argc) {
+            if (smp_parse_balance(argv[++i], &smp.balance) != 0) {
+                fprintf(stderr, "Unknown balancing mode: %s\n", argv[i]);
+                return 2;
+            }
+        } else if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc) {
+            trace_dir = argv[++i];
+        } else if (strcmp(argv[i], "--online") == 0 && i + 1 < argc) {
+            const char *name = argv[++i];
+            for (int a = 0; a < ALGO_COUNT; a++) {
+                if (strcmp(name, algo_slugs[a]) == 0) online = a;
+            }
+            if (online < 0) {
+                fprintf(stderr, "Unknown policy: %s\n", name);
+                return 2;
+            }
+        } else if (strcmp(argv[i], "--socket") == 0 && i + 1 < argc) {
+            socket_path = argv[++i];
+        } else if (strcmp(argv[i], "--max-jobs") == 0 && i + 1 < argc) {
+            max_jobs = atoi(argv[++i]);
+            if (max_jobs < 1) {
+                fprintf(stderr, "Job limit must be at least 1\n");
+                return 2;
+            }
+        } else if (strcmp(argv[i], "--quiet") == 0) {
+            quiet = 1;
+        } else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc) {
+            replay = argv[++i];
+        } else if (strcmp(argv[i], "--window") == 0 && i + 1 < argc) {
+            if (sweep_parse_range(argv[++i], &window) != 0) {
+                fprintf(stderr, "Invalid window: %s\n", argv[i]);
+                return 2;
+            }
+            has_window = 1;
+        } else if (argv[i][0] == '-') {
+            usage(argv[0]);
+            return 2;
+        } else {
+            path = argv[i];
+        }
+    }
+
+    if (replay) return print_replay(replay, has_window ? &window : NULL);
+
+    if (online >= 0) {
+        int quantums[] = {2, 4, 8};
+        mlfq_config_t mlfq = {3, quantums, 10};
+        sim_params_t params = {(sim_policy_t)online, quantum, &mlfq, &cfs, seed, aging_interval};
+        if (socket_path) return serve_online(socket_path, &params, max_jobs, quiet, json);
+        return run_online(STDIN_FILENO, stdout, stderr, "stdin", &params, max_jobs, quiet, json) == 0 ? 0 : 1;
+    }
+
+    if (replicate) {
+        replicate_result_t results[SIM_POLICY_COUNT];
+        rep.seed = seed;
+        rep.threads = spec.threads;
+        rep.params.quantum = quantum;
+        rep.params.cfs = &cfs;
+        rep.params.aging_interval = aging_interval;
+        if (replicate_run(&rep, results) != 0) {
+            fprintf(stderr, "Replication failed: out of memory\n");
+            return 1;
+        }
+        print_replicate(&rep, results, json);
+        return 0;
+    }
+
+    process_t *workload;
+    int n = path ? workload_load(path, &workload) : default_workload(&workload);
+    if (n < 0) return 1;
+
+    const char *source = path ? path : "built-in workload 1";
+
+    if (sweep) {
+        sweep_result_t *results;
+        long count = sweep_run(workload, n, &spec, &results);
+        free(workload);
+        if (count < 0) {
+            fprintf(stderr, "Sweep failed: out of memory\n");
+            return 1;
+        }
+        print_sweep(source, n, results, count, json, sweep_all);
+        free(results);
+        return 0;
+    }
+
     int quantums[] = {2, 4, 8};
-    config.quantums = quantums;
-    config.boost_interval = 10;
-    schedule_mlfq(processes, n, &config, timeline);
-    max_time = 0;
-    for(int i=0; i<n; i++) if(processes[i].completion_time > max_time) max_time = processes[i].completion_time;
-    calculate_metrics(processes, n, max_time, &metrics);
-    print_metrics("MLFQ", &metrics);
+    mlfq_config_t mlfq = {3, quantums, 10};
+
+    smp.cpus = cpus;
+    job_t jobs[ALGO_COUNT];
+    pthread_t threads[ALGO_COUNT];
+    int started[ALGO_COUNT];
+
+    for (int a = 0; a < ALGO_COUNT; a++) {
+        jobs[a].algo = (algorithm_t)a;
+        jobs[a].workload = workload;
+        jobs[a].n = n;
+        jobs[a].quantum = quantum;
+        jobs[a].mlfq = &mlfq;
+        jobs[a].cfs = &cfs;
+        jobs[a].seed = seed;
+        jobs[a].aging_interval = aging_interval;
+        jobs[a].smp = cpus > 0 ? &smp : NULL;
+        jobs[a].trace_dir = trace_dir;
+        jobs[a].trace_failed = 0;
+        memset(&jobs[a].metrics, 0, sizeof(metrics_t));
+        memset(&jobs[a].stats, 0, sizeof(smp_stats_t));
+        if (jobs[a].smp) {
+            jobs[a].stats.core_utilization = calloc(cpus, sizeof(double));
+            if (!jobs[a].stats.core_utilization) {
+                fprintf(stderr, "Out of memory\n");
+                return 1;
+            }
+        }
+        jobs[a].events = -1;
 
+        // Fall back to running inline if the thread can't be created
+        started[a] = pthread_create(&threads[a], NULL, run_job, &jobs[a]) == 0;
+        if (!started[a]) run_job(&jobs[a]);
+    }
+    for (int a = 0; a < ALGO_COUNT; a++) {
+        if (started[a]) pthread_join(threads[a], NULL);
+    }
+
+    if (json) {
+        print_json(source, n, cpus > 0 ? &smp : NULL, jobs);
+    } else {
+        print_table(source, n, jobs);
+        if (cpus > 0) print_smp_table(&smp, jobs);
+#ifdef SCHED_INSTRUMENT
+        // The multi-core engine only reaches the policies' own counters
+        if (cpus > 0) printf("\nCounters: not collected for --cpus runs\n");
+        else print_counters_table(jobs);
+#endif
+    }
+
+    free(workload);
+    for (int a = 0; a < ALGO_COUNT; a++) free(jobs[a].stats.core_utilization);
+
+    for (int a = 0; a < ALGO_COUNT; a++) {
+        if (jobs[a].events < 0 || jobs[a].trace_failed) return 1;
+    }
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,26 @@
+#include <string.h>
+#include "scratch.h"
+
+void worker_scratch_init(worker_scratch_t *s) {
+    memset(s, 0, sizeof(*s));
+    timeline_init(&s->timeline);
+    arena_init(&s->arena);
+}
+
+void worker_scratch_free(worker_scratch_t *s) {
+    proc_table_free(&s->table);
+    timeline_free(&s->timeline);
+    arena_free(&s->arena);
+    memset(s, 0, sizeof(*s));
+}
+
+int worker_scratch_table(worker_scratch_t *s, int n) {
+    if (!s->table.block || n > s->capacity) {
+        proc_table_free(&s->table);
+        s->capacity = 0;
+        if (proc_table_init(&s->table, n) != 0) return -1;
+        s->capacity = n;
+    }
+    s->table.n = n;
+    return 0;
+}
@@ -0,0 +1,580 @@
+#include <string.h>
+#include <limits.h>
+#include "smp.h"
+#include "policy.h"
+#include "instrument.h"
+
+// Discrete-event multi-core engine. The clock jumps to the next event: an
+// arrival, the end of some core's slice, or a push-balance tick. Cores are
+// kept in an indexed min-heap on their slice end, so finding the next one is
+// O(1) and updating one is O(log cpus). Each step runs in a fixed order:
+//
+//   1. Stop every core whose slice ends now.
+//   2. Admit arrivals (they queue ahead of the jobs stopped in 1, as on one CPU).
+//   3. Finish or requeue the stopped jobs on their own core's queue.
+//   4. MLFQ priority boost, push balancing.
+//   5. Cores whose queue changed, or that went idle, dispatch, preempt or steal.
+//
+// The queues themselves belong to the policy (see policy.h), one per core.
+// Slices are capped as on one CPU, at the policy's slice and the next boost.
+// Preemptive policies (STCF, MLFQ) preempt when a better job lands on a busy
+// core's queue (or, with a global queue, the worst running job anywhere).
+
+// ------------------------------------------------------
+// State
+// ------------------------------------------------------
+
+// One simulated core. Each gets its own cache line, so a step touches only
+// the lines of the cores it changes.
+typedef struct {
+    int running;            // Job index, -1 when idle
+    int run_start;          // When 'running' was dispatched
+    int run_end;            // When its slice ends unless preempted (INT_MAX when idle)
+    int dirty;              // On this step's attention list
+    int seg_open;           // Timeline segment still being extended
+    int seg_pid;
+    int seg_start;
+    int seg_end;
+    long long busy;         // Time spent running jobs
+} __attribute__((aligned(64))) smp_core_t;
+
+typedef struct {
+    proc_table_t *t;
+    sched_policy_t *p;          // One queue per core, or one shared (SMP_GLOBAL)
+    long long next_boost;
+    smp_balance_t balance;
+    long long balance_interval;
+    long long next_balance;
+
+    int cpus;
+    smp_core_t *cores;
+    int *nr_ready;              // Jobs on each policy queue
+
+    // Per job
+    int *last_cpu;              // Core the job last ran on, -1 if never
+    int *order;                 // Admission order
+    int next;                   // Cursor into 'order'
+
+    // Per core scratch
+    uint64_t *events;           // Min-heap of event_key(run_end, cpu)
+    int *event_pos;             // Position of each core in 'events'
+    uint64_t *idle;             // Bit per idle core
+    int nr_idle;
+    int *dirty;                 // Cores to settle this step
+    int nr_dirty;
+    int *stopped;               // Cores stopped this step, in stop order
+    int *stopped_job;
+    int *stopped_ran;
+    int global_dirty;           // SMP_GLOBAL: the shared queue gained jobs
+
+    int queued;                 // Jobs waiting in any queue
+    int time;
+    int completed;
+    long migrations;
+    timeline_t *timeline;
+    metrics_acc_t *acc;
+    arena_t *arena;             // Where the run's state lives (NULL: the heap)
+} smp_sim_t;
+
+void smp_default_config(smp_config_t *config, int cpus) {
+    config->cpus = cpus;
+    config->balance = SMP_STEAL;
+    config->balance_interval = 10;
+}
+
+static const char *balance_names[] = {"global", "push", "steal"};
+
+int smp_parse_balance(const char *text, smp_balance_t *balance) {
+    for (int b = SMP_GLOBAL; b <= SMP_STEAL; b++) {
+        if (strcmp(text, balance_names[b]) == 0) {
+            *balance = (smp_balance_t)b;
+            return 0;
+        }
+    }
+    return -1;
+}
+
+const char *smp_balance_name(smp_balance_t balance) {
+    return balance_names[balance];
+}
+
+static int queue_of(const smp_sim_t *sim, int cpu) {
+    return sim->balance == SMP_GLOBAL ? 0 : cpu;
+}
+
+// Queue operations that keep the ready counts in step
+static void rq_push(smp_sim_t *sim, int q, int idx) {
+    sim->p->ops->enqueue(sim->p, q, idx);
+    sim->nr_ready[q]++;
+    sim->queued++;
+}
+
+static void rq_requeue(smp_sim_t *sim, int q, int idx, int ran) {
+    sim->p->ops->on_tick_expiry(sim->p, q, idx, ran);
+    sim->nr_ready[q]++;
+    sim->queued++;
+}
+
+static int rq_pop(smp_sim_t *sim, int q) {
+    sim->nr_ready[q]--;
+    sim->queued--;
+    return sim->p->ops->pick_next(sim->p, q);
+}
+
+// Moves 'count' queued jobs from the back of queue 'from' to queue 'to', so
+// 'from' keeps its best jobs and its virtual clock
+static void rq_migrate(smp_sim_t *sim, int from, int to, int count) {
+    const sched_policy_ops_t *ops = sim->p->ops;
+    if (ops->migrate) {
+        ops->migrate(sim->p, from, to, count);
+    } else {
+        for (int k = 0; k < count; k++) ops->enqueue(sim->p, to, ops->pick_next(sim->p, from));
+    }
+    sim->nr_ready[from] -= count;
+    sim->nr_ready[to] += count;
+}
+
+// ------------------------------------------------------
+// Cores
+// ------------------------------------------------------
+
+// Heap key ordering cores by (run_end, cpu) with one integer compare, so
+// sifting never touches the cores' own cache lines
+static uint64_t event_key(int run_end, int cpu) {
+    return (uint64_t)((uint32_t)run_end ^ 0x80000000u) << 32 | (uint32_t)cpu;
+}
+
+static int event_cpu(uint64_t key) {
+    return (int)(uint32_t)key;
+}
+
+static int next_event_time(const smp_sim_t *sim) {
+    return (int)((uint32_t)(sim->events[0] >> 32) ^ 0x80000000u);
+}
+
+// Restores the event heap after core 'cpu' changed its slice end
+static void events_fix(smp_sim_t *sim, int cpu) {
+    uint64_t *heap = sim->events;
+    int *pos = sim->event_pos;
+    uint64_t key = event_key(sim->cores[cpu].run_end, cpu);
+    int i = pos[cpu];
+
+    while (i > 0 && key < heap[(i - 1) / 2]) {
+        heap[i] = heap[(i - 1) / 2];
+        pos[event_cpu(heap[i])] = i;
+        i = (i - 1) / 2;
+    }
+    while (1) {
+        int child = 2 * i + 1;
+        if (child >= sim->cpus) break;
+        if (child + 1 < sim->cpus && heap[child + 1] < heap[child]) child++;
+        if (heap[child] >= key) break;
+        heap[i] = heap[child];
+        pos[event_cpu(heap[i])] = i;
+        i = child;
+    }
+    heap[i] = key;
+    pos[cpu] = i;
+}
+
+static void set_idle(smp_sim_t *sim, int cpu, int idle) {
+    uint64_t bit = (uint64_t)1 << (cpu & 63);
+    if (idle) sim->idle[cpu >> 6] |= bit;
+    else sim->idle[cpu >> 6] &= ~bit;
+    sim->nr_idle += idle ? 1 : -1;
+}
+
+// Lowest-numbered idle core, or -1
+static int first_idle(const smp_sim_t *sim) {
+    for (int w = 0; w < (sim->cpus + 63) / 64; w++) {
+        if (sim->idle[w]) return w * 64 + __builtin_ctzll(sim->idle[w]);
+    }
+    return -1;
+}
+
+static void mark_dirty(smp_sim_t *sim, int cpu) {
+    if (sim->balance == SMP_GLOBAL) {
+        sim->global_dirty = 1;
+    } else if (!sim->cores[cpu].dirty) {
+        sim->cores[cpu].dirty = 1;
+        sim->dirty[sim->nr_dirty++] = cpu;
+    }
+}
+
+static void enqueue(smp_sim_t *sim, int cpu, int idx) {
+    rq_push(sim, queue_of(sim, cpu), idx);
+    mark_dirty(sim, cpu);
+}
+
+static void segment_flush(smp_sim_t *sim, int cpu) {
+    smp_core_t *c = &sim->cores[cpu];
+    if (!c->seg_open) return;
+    if (timeline_append_cpu(sim->timeline, cpu, c->seg_start, c->seg_pid, c->seg_end - c->seg_start) != 0) {
+        sim->p->failed = 1;
+    }
+    c->seg_open = 0;
+}
+
+static void dispatch(smp_sim_t *sim, int cpu, int idx) {
+    proc_table_t *t = sim->t;
+    smp_core_t *c = &sim->cores[cpu];
+
+    if (sim->last_cpu[idx] != cpu) {
+        if (sim->last_cpu[idx] >= 0) sim->migrations++;
+        sim->last_cpu[idx] = cpu;
+    }
+    if (t->remaining_time[idx] == t->burst_time[idx]) {
+        t->start_time[idx] = sim->time;
+    }
+
+    // Back-to-back slices of the same process form one timeline event
+    if (!c->seg_open || c->seg_pid != t->pid[idx] || c->seg_end != sim->time) {
+        segment_flush(sim, cpu);
+        c->seg_open = 1;
+        c->seg_pid = t->pid[idx];
+        c->seg_start = sim->time;
+    }
+
+    long long run_time = t->remaining_time[idx];
+    int slice = sim->p->ops->slice(sim->p, idx);
+    if (slice < run_time) run_time = slice;
+    if (sim->next_boost - sim->time < run_time) run_time = sim->next_boost - sim->time;
+
+    c->running = idx;
+    c->run_start = sim->time;
+    c->run_end = sim->time + (int)run_time;
+    set_idle(sim, cpu, 0);
+    events_fix(sim, cpu);
+}
+
+// Takes the running job off 'cpu' at the current time and returns it, with
+// how long it ran in '*ran'
+static int stop_running(smp_sim_t *sim, int cpu, int *ran_out) {
+    smp_core_t *c = &sim->cores[cpu];
+    int idx = c->running;
+    int ran = sim->time - c->run_start;
+
+    sim->t->remaining_time[idx] -= ran;
+    c->busy += ran;
+    c->seg_end = sim->time;
+
+    c->running = -1;
+    c->run_end = INT_MAX;
+    set_idle(sim, cpu, 1);
+    events_fix(sim, cpu);
+    *ran_out = ran;
+    return idx;
+}
+
+// A job whose slice ended: completion, or back onto its core's queue
+static void requeue_stopped(smp_sim_t *sim, int cpu, int idx, int ran) {
+    if (sim->t->remaining_time[idx] == 0) {
+        sim->completed++;
+        proc_table_finish(sim->t, idx, sim->time, sim->acc);
+    } else {
+        rq_requeue(sim, queue_of(sim, cpu), idx, ran);
+    }
+    mark_dirty(sim, cpu);
+}
+
+// Work the job running on 'cpu' still has at the current time
+static int running_left(const smp_sim_t *sim, int cpu) {
+    const smp_core_t *c = &sim->cores[cpu];
+    return sim->t->remaining_time[c->running] - (sim->time - c->run_start);
+}
+
+// Non-zero if the best job on queue 'q' should displace the one running on 'cpu'
+static int preempts(const smp_sim_t *sim, int q, int cpu) {
+    int running = sim->cores[cpu].running;
+    if (!sim->p->ops->preempts || sim->nr_ready[q] == 0 || running == -1) return 0;
+    return sim->p->ops->preempts(sim->p, q, running, running_left(sim, cpu));
+}
+
+static void preempt(smp_sim_t *sim, int q, int cpu) {
+    int ran;
+    int prev = stop_running(sim, cpu, &ran);
+    rq_requeue(sim, q, prev, ran);
+    dispatch(sim, cpu, rq_pop(sim, q));
+}
+
+// ------------------------------------------------------
+// Balancing
+// ------------------------------------------------------
+
+static int core_load(const smp_sim_t *sim, int cpu) {
+    return (sim->cores[cpu].running != -1) + sim->nr_ready[cpu];
+}
+
+// Moves half of the longest other queue to 'thief', from its back
+static void steal(smp_sim_t *sim, int thief) {
+    int victim = -1;
+    int most = 0;
+    if (sim->queued == 0) return;
+    for (int cpu = 0; cpu < sim->cpus; cpu++) {
+        if (cpu != thief && sim->nr_ready[cpu] > most) {
+            most = sim->nr_ready[cpu];
+            victim = cpu;
+        }
+    }
+    if (victim >= 0) rq_migrate(sim, victim, thief, (most + 1) / 2);
+}
+
+// Moves queued jobs from cores loaded above 'above' to cores below 'below'
+static void push_pass(smp_sim_t *sim, int above, int below) {
+    int to = 0;
+    for (int from = 0; from < sim->cpus; from++) {
+        while (core_load(sim, from) > above && sim->nr_ready[from] > 0) {
+            while (to < sim->cpus && core_load(sim, to) >= below) to++;
+            if (to == sim->cpus) return;
+
+            int count = core_load(sim, from) - above;
+            if (count > sim->nr_ready[from]) count = sim->nr_ready[from];
+            if (count > below - core_load(sim, to)) count = below - core_load(sim, to);
+            rq_migrate(sim, from, to, count);
+            mark_dirty(sim, to);
+        }
+    }
+}
+
+// Evens out the load (running + queued jobs) to within one job per core.
+// Running jobs stay put, so only queued ones move.
+static void push_balance(smp_sim_t *sim) {
+    int total = sim->cpus - sim->nr_idle + sim->queued;
+    int lo = total / sim->cpus;
+    int hi = lo + (total % sim->cpus != 0);
+
+    push_pass(sim, hi, lo);
+    push_pass(sim, hi, hi);
+    push_pass(sim, lo, lo);
+}
+
+// Per-core queues: an idle core runs its own queue, or steals; a busy one
+// is preempted if its queue now holds a better job
+static void settle_core(smp_sim_t *sim, int cpu) {
+    if (sim->cores[cpu].running == -1) {
+        if (sim->nr_ready[cpu] == 0 && sim->balance == SMP_STEAL) steal(sim, cpu);
+        if (sim->nr_ready[cpu] > 0) dispatch(sim, cpu, rq_pop(sim, cpu));
+    } else if (preempts(sim, cpu, cpu)) {
+        preempt(sim, cpu, cpu);
+    }
+}
+
+// Running core with the job that has the weakest claim to its CPU, or -1
+static int worst_running(const smp_sim_t *sim) {
+    int worst = -1;
+    long long worst_key = LLONG_MIN;
+
+    for (int cpu = 0; cpu < sim->cpus; cpu++) {
+        const smp_core_t *c = &sim->cores[cpu];
+        if (c->running == -1) continue;
+        long long key = sim->p->ops->rank(sim->p, c->running, running_left(sim, cpu));
+        if (key > worst_key) {
+            worst_key = key;
+            worst = cpu;
+        }
+    }
+    return worst;
+}
+
+// Shared queue: idle cores take jobs, lowest id first; then the best waiting
+// job displaces the worst running one until none does
+static void settle_global(smp_sim_t *sim) {
+    while (sim->nr_ready[0] > 0 && sim->nr_idle > 0) {
+        dispatch(sim, first_idle(sim), rq_pop(sim, 0));
+    }
+    if (!sim->global_dirty || !sim->p->ops->preempts) return;
+    sim->global_dirty = 0;
+
+    while (sim->nr_ready[0] > 0) {
+        int victim = worst_running(sim);
+        if (victim < 0 || !preempts(sim, 0, victim)) break;
+        preempt(sim, 0, victim);
+    }
+}
+
+// ------------------------------------------------------
+// Engine
+// ------------------------------------------------------
+
+static void smp_free(smp_sim_t *sim) {
+    arena_t *a = sim->arena;
+    sched_policy_destroy(sim->p);
+    arena_release(a, sim->cores);
+    arena_release(a, sim->nr_ready);
+    arena_release(a, sim->last_cpu);
+    arena_release(a, sim->order);
+    arena_release(a, sim->events);
+    arena_release(a, sim->event_pos);
+    arena_release(a, sim->idle);
+    arena_release(a, sim->dirty);
+    arena_release(a, sim->stopped);
+    arena_release(a, sim->stopped_job);
+    arena_release(a, sim->stopped_ran);
+}
+
+static int smp_init(smp_sim_t *sim, proc_table_t *t, int cpus, const sim_params_t *params) {
+    arena_t *a = sim->arena;
+    int n = t->n;
+    int nr_queues = sim->balance == SMP_GLOBAL ? 1 : cpus;
+
+    sim->cpus = cpus;
+    sim->p = sched_policy_create(params, t, nr_queues, a);
+    // Arena blocks are cache-line aligned already; malloc is not
+    sim->cores = a ? arena_alloc(a, sizeof(smp_core_t) * cpus) : aligned_alloc(64, sizeof(smp_core_t) * cpus);
+    sim->nr_ready = arena_calloc(a, nr_queues, sizeof(int));
+    sim->last_cpu = arena_alloc(a, sizeof(int) * (n > 0 ? n : 1));
+    sim->events = arena_alloc(a, sizeof(uint64_t) * cpus);
+    sim->event_pos = arena_alloc(a, sizeof(int) * cpus);
+    sim->idle = arena_calloc(a, (cpus + 63) / 64, sizeof(uint64_t));
+    sim->dirty = arena_alloc(a, sizeof(int) * cpus);
+    sim->stopped = arena_alloc(a, sizeof(int) * cpus);
+    sim->stopped_job = arena_alloc(a, sizeof(int) * cpus);
+    sim->stopped_ran = arena_alloc(a, sizeof(int) * cpus);
+    if (!sim->p || !sim->cores || !sim->nr_ready || !sim->last_cpu || !sim->events ||
+        !sim->event_pos || !sim->idle || !sim->dirty || !sim->stopped || !sim->stopped_job ||
+        !sim->stopped_ran) {
+        return -1;
+    }
+
+    // Admission order: by arrival, or table order for admit_by_index policies
+    if (sim->p->ops->admit_by_index) {
+        sim->order = arena_alloc(a, sizeof(int) * (n > 0 ? n : 1));
+        for (int i = 0; sim->order && i < n; i++) sim->order[i] = i;
+    } else {
+        sim->order = proc_table_arrival_order(t, a);
+    }
+    if (!sim->order) return -1;
+
+    // Every core starts idle; equal keys make the identity a valid heap
+    for (int cpu = 0; cpu < cpus; cpu++) {
+        smp_core_t *c = &sim->cores[cpu];
+        memset(c, 0, sizeof(*c));
+        c->running = -1;
+        c->run_end = INT_MAX;
+        sim->events[cpu] = event_key(INT_MAX, cpu);
+        sim->event_pos[cpu] = cpu;
+        sim->idle[cpu >> 6] |= (uint64_t)1 << (cpu & 63);
+    }
+    sim->nr_idle = cpus;
+
+    for (int i = 0; i < n; i++) {
+        t->remaining_time[i] = t->burst_time[i];
+        sim->last_cpu[i] = -1;
+        if (sim->p->ops->reset) sim->p->ops->reset(sim->p, i);
+    }
+    return 0;
+}
+
+long schedule_smp_table(proc_table_t *t, const sim_params_t *params, const smp_config_t *config,
+                        arena_t *arena, timeline_t *timeline, metrics_acc_t *acc, smp_stats_t *stats) {
+    smp_sim_t sim;
+    int n = t->n;
+    int cpus = config->cpus;
+    if (cpus < 1) cpus = 1;
+    if (cpus > SMP_MAX_CPUS) cpus = SMP_MAX_CPUS;
+
+    memset(&sim, 0, sizeof(sim));
+    sim.t = t;
+    sim.balance = config->balance;
+    sim.balance_interval = config->balance_interval < 1 ? 1 : config->balance_interval;
+    sim.next_balance = sim.balance_interval;
+    sim.timeline = timeline;
+    sim.acc = acc;
+    sim.arena = arena;
+
+    SCHED_RESET();
+    arena_reset(arena);
+    timeline_clear(timeline);
+    if (smp_init(&sim, t, cpus, params) != 0) {
+        smp_free(&sim);
+        return -1;
+    }
+
+    // Boosts happen at every multiple of boost_interval
+    long long boost_interval = sim.p->boost_interval;
+    sim.next_boost = boost_interval > 0 ? boost_interval : LLONG_MAX;
+
+    while (sim.completed < n && !sim.p->failed) {
+        // Next event
+        long long now = LLONG_MAX;
+        if (sim.next < n) now = t->arrival_time[sim.order[sim.next]];
+        if (next_event_time(&sim) < now) now = next_event_time(&sim);
+        if (sim.balance == SMP_PUSH && sim.queued > 0 && sim.next_balance < now) now = sim.next_balance;
+        if (now == LLONG_MAX) break;
+        sim.time = (int)now;
+
+        // 1. Slices that end now
+        int nr_stopped = 0;
+        while (next_event_time(&sim) == sim.time) {
+            int cpu = event_cpu(sim.events[0]);
+            sim.stopped[nr_stopped] = cpu;
+            sim.stopped_job[nr_stopped] = stop_running(&sim, cpu, &sim.stopped_ran[nr_stopped]);
+            nr_stopped++;
+        }
+
+        // 2. Arrivals, spread round-robin over the per-core queues
+        while (sim.next < n && t->arrival_time[sim.order[sim.next]] <= sim.time) {
+            enqueue(&sim, sim.next % cpus, sim.order[sim.next]);
+            sim.next++;
+        }
+
+        // 3. Completion or requeue
+        for (int k = 0; k < nr_stopped; k++) {
+            requeue_stopped(&sim, sim.stopped[k], sim.stopped_job[k], sim.stopped_ran[k]);
+        }
+
+        // 4. Boost and push balancing
+        if (sim.time >= sim.next_boost) {
+            if (sim.queued > 0) sim.p->ops->on_boost(sim.p);
+            sim.next_boost = (sim.time / boost_interval + 1) * boost_interval;
+        }
+        if (sim.balance == SMP_PUSH && sim.time >= sim.next_balance) {
+            push_balance(&sim);
+            sim.next_balance = (sim.time / sim.balance_interval + 1) * sim.balance_interval;
+        }
+
+        // 5. Dispatch, preemption and stealing
+        if (sim.balance == SMP_GLOBAL) {
+            settle_global(&sim);
+        } else {
+            for (int k = 0; k < sim.nr_dirty; k++) {
+                sim.cores[sim.dirty[k]].dirty = 0;
+                settle_core(&sim, sim.dirty[k]);
+            }
+            sim.nr_dirty = 0;
+
+            // Idle cores pull jobs still waiting behind busy ones
+            if (sim.balance == SMP_STEAL) {
+                int cpu;
+                while (sim.queued > 0 && (cpu = first_idle(&sim)) >= 0) {
+                    if (sim.nr_ready[cpu] == 0) steal(&sim, cpu);
+                    dispatch(&sim, cpu, rq_pop(&sim, cpu));
+                }
+            }
+        }
+    }
+
+    for (int cpu = 0; cpu < cpus; cpu++) segment_flush(&sim, cpu);
+
+    if (stats) {
+        long long busy = 0;
+        int makespan = 0;
+        for (int i = 0; i < n; i++) {
+            if (t->completion_time[i] > makespan) makespan = t->completion_time[i];
+        }
+        stats->cpus = cpus;
+        stats->migrations = sim.migrations;
+        stats->makespan = makespan;
+        for (int cpu = 0; cpu < cpus; cpu++) {
+            busy += sim.cores[cpu].busy;
+            if (stats->core_utilization) {
+                stats->core_utilization[cpu] = makespan > 0 ? 100.0 * sim.cores[cpu].busy / makespan : 0;
+            }
+        }
+        stats->utilization = makespan > 0 ? 100.0 * busy / ((double)makespan * cpus) : 0;
+    }
+
+    long events = sim.completed == n && !sim.p->failed ? (long)timeline->count : -1;
+    smp_free(&sim);
+    return events;
+}
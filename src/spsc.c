@@ -0,0 +1,41 @@
+#include <stdlib.h>
+#include "spsc.h"
+
+int spsc_init(spsc_queue_t *q, size_t capacity) {
+    size_t size = 2;
+    while (size < capacity) size *= 2;
+
+    q->slots = malloc(sizeof(void *) * size);
+    if (!q->slots) return -1;
+    q->mask = size - 1;
+    atomic_init(&q->head, 0);
+    atomic_init(&q->tail, 0);
+    return 0;
+}
+
+void spsc_free(spsc_queue_t *q) {
+    free(q->slots);
+    q->slots = NULL;
+}
+
+int spsc_push(spsc_queue_t *q, void *item) {
+    size_t tail = atomic_load_explicit(&q->tail, memory_order_relaxed);
+    size_t head = atomic_load_explicit(&q->head, memory_order_acquire);
+    if (tail - head > q->mask) return -1;
+
+    q->slots[tail & q->mask] = item;
+    // Publish the slot before the consumer can see the new tail
+    atomic_store_explicit(&q->tail, tail + 1, memory_order_release);
+    return 0;
+}
+
+void *spsc_pop(spsc_queue_t *q) {
+    size_t head = atomic_load_explicit(&q->head, memory_order_relaxed);
+    size_t tail = atomic_load_explicit(&q->tail, memory_order_acquire);
+    if (head == tail) return NULL;
+
+    void *item = q->slots[head & q->mask];
+    // Hand the slot back to the producer only after it has been read
+    atomic_store_explicit(&q->head, head + 1, memory_order_release);
+    return item;
+}
@@ -0,0 +1,180 @@
+#include <string.h>
+#include <limits.h>
+#include "sweep.h"
+#include "threadpool.h"
+#include "scratch.h"
+#include "policy.h"
+
+typedef struct {
+    proc_table_t workload;      // Shared, never written
+    sweep_result_t *results;
+    worker_scratch_t *workers;  // Reused for every grid point a worker runs
+} sweep_job_t;
+
+void sweep_default_spec(sweep_spec_t *spec) {
+    spec->rr_quantum = (sweep_range_t){1, 20, 1};
+    spec->mlfq_levels = (sweep_range_t){2, 4, 1};
+    spec->mlfq_quantum = (sweep_range_t){1, 8, 1};
+    spec->mlfq_factor = (sweep_range_t){1, 3, 1};
+    spec->mlfq_boost = (sweep_range_t){0, 200, 25};
+    spec->threads = 0;
+}
+
+int sweep_parse_range(const char *text, sweep_range_t *range) {
+    char *end;
+    long min = strtol(text, &end, 10);
+    long max = min;
+    long step = 1;
+
+    if (end == text) return -1;
+    if (*end == ':') {
+        const char *s = end + 1;
+        max = strtol(s, &end, 10);
+        if (end == s) return -1;
+        if (*end == ':') {
+            s = end + 1;
+            step = strtol(s, &end, 10);
+            if (end == s) return -1;
+        }
+    }
+    if (*end != '\0' || min < 0 || max > INT_MAX || step > INT_MAX) return -1;
+
+    range->min = (int)min;
+    range->max = (int)max;
+    range->step = (int)step;
+    return 0;
+}
+
+static int range_count(const sweep_range_t *r) {
+    int step = r->step > 0 ? r->step : 1;
+    if (r->min > r->max) return 0;
+    return (int)(((long)r->max - r->min) / step + 1);
+}
+
+static int range_value(const sweep_range_t *r, int i) {
+    int step = r->step > 0 ? r->step : 1;
+    return r->min + i * step;
+}
+
+static void run_point(void *ctx, int worker, size_t task) {
+    sweep_job_t *job = ctx;
+    worker_scratch_t *w = &job->workers[worker];
+    sweep_result_t *r = &job->results[task];
+
+    proc_table_copy_inputs(&w->table, &job->workload);
+    metrics_acc_init(&w->acc);
+
+    if (r->policy == SWEEP_RR) {
+        sim_params_t params = {.policy = SIM_RR, .quantum = r->quantum};
+        r->events = schedule_params_table(&params, &w->table, &w->arena, &w->timeline, &w->acc);
+    } else {
+        int quantums[MLFQ_MAX_QUEUES];
+        long q = r->quantum;
+        for (int l = 0; l < r->levels; l++) {
+            quantums[l] = (int)q;
+            if (q <= INT_MAX / (r->factor > 0 ? r->factor : 1)) q *= r->factor;
+        }
+        mlfq_config_t cfg = {r->levels, quantums, r->boost_interval};
+        sim_params_t params = {.policy = SIM_MLFQ, .mlfq = &cfg};
+        r->events = schedule_params_table(&params, &w->table, &w->arena, &w->timeline, &w->acc);
+    }
+
+    if (r->events >= 0) metrics_acc_finish(&w->acc, 0, &r->metrics);
+}
+
+// Orders by turnaround, then response; failed runs sort last
+static int compare_front(const void *a, const void *b) {
+    const sweep_result_t *x = *(const sweep_result_t * const *)a;
+    const sweep_result_t *y = *(const sweep_result_t * const *)b;
+    if ((x->events < 0) != (y->events < 0)) return x->events < 0 ? 1 : -1;
+    if (x->metrics.avg_turnaround_time != y->metrics.avg_turnaround_time) {
+        return x->metrics.avg_turnaround_time < y->metrics.avg_turnaround_time ? -1 : 1;
+    }
+    if (x->metrics.avg_response_time != y->metrics.avg_response_time) {
+        return x->metrics.avg_response_time < y->metrics.avg_response_time ? -1 : 1;
+    }
+    return 0;
+}
+
+// A point is on the front if no other point is at least as good on both
+// axes and strictly better on one. After sorting by turnaround, that is
+// every point whose response beats everything before it.
+static void mark_pareto(sweep_result_t *results, long count) {
+    sweep_result_t **sorted = malloc(sizeof(sweep_result_t *) * (count > 0 ? count : 1));
+    if (!sorted) return;
+
+    for (long i = 0; i < count; i++) {
+        sorted[i] = &results[i];
+        results[i].pareto = 0;
+    }
+    qsort(sorted, count, sizeof(sweep_result_t *), compare_front);
+
+    // Exact ties with the last front point are non-dominated as well
+    const metrics_t *best = NULL;
+    for (long i = 0; i < count && sorted[i]->events >= 0; i++) {
+        const metrics_t *m = &sorted[i]->metrics;
+        if (!best || m->avg_response_time < best->avg_response_time ||
+            (m->avg_response_time == best->avg_response_time &&
+             m->avg_turnaround_time == best->avg_turnaround_time)) {
+            sorted[i]->pareto = 1;
+            best = m;
+        }
+    }
+    free(sorted);
+}
+
+long sweep_run(const process_t *workload, int n, const sweep_spec_t *spec, sweep_result_t **results) {
+    sweep_range_t levels = spec->mlfq_levels;
+    if (levels.min < 1) levels.min = 1;
+    if (levels.max > MLFQ_MAX_QUEUES) levels.max = MLFQ_MAX_QUEUES;
+
+    long rr_points = range_count(&spec->rr_quantum);
+    long mlfq_points = (long)range_count(&levels) * range_count(&spec->mlfq_quantum) *
+                       range_count(&spec->mlfq_factor) * range_count(&spec->mlfq_boost);
+    long count = rr_points + mlfq_points;
+
+    sweep_result_t *out = calloc(count > 0 ? count : 1, sizeof(sweep_result_t));
+    if (!out) return -1;
+
+    // Lay out the grid
+    long k = 0;
+    for (int i = 0; i < rr_points; i++) {
+        out[k].policy = SWEEP_RR;
+        out[k++].quantum = range_value(&spec->rr_quantum, i);
+    }
+    for (int l = 0; l < range_count(&levels); l++)
+        for (int q = 0; q < range_count(&spec->mlfq_quantum); q++)
+            for (int f = 0; f < range_count(&spec->mlfq_factor); f++)
+                for (int b = 0; b < range_count(&spec->mlfq_boost); b++) {
+                    out[k].policy = SWEEP_MLFQ;
+                    out[k].levels = range_value(&levels, l);
+                    out[k].quantum = range_value(&spec->mlfq_quantum, q);
+                    out[k].factor = range_value(&spec->mlfq_factor, f);
+                    out[k++].boost_interval = range_value(&spec->mlfq_boost, b);
+                }
+
+    int workers = spec->threads > 0 ? spec->threads : pool_default_workers();
+    if (workers > count) workers = count > 0 ? (int)count : 1;
+
+    sweep_job_t job = { .results = out, .workers = calloc(workers, sizeof(worker_scratch_t)) };
+    int ok = job.workers != NULL && proc_table_from_array(&job.workload, workload, n) == 0;
+    for (int w = 0; ok && w < workers; w++) {
+        worker_scratch_init(&job.workers[w]);
+        if (worker_scratch_table(&job.workers[w], n) != 0) ok = 0;
+    }
+
+    if (ok) ok = pool_run(workers, count, run_point, &job) >= 0;
+
+    for (int w = 0; job.workers && w < workers; w++) worker_scratch_free(&job.workers[w]);
+    free(job.workers);
+    proc_table_free(&job.workload);
+
+    if (!ok) {
+        free(out);
+        return -1;
+    }
+
+    mark_pareto(out, count);
+    *results = out;
+    return count;
+}
@@ -0,0 +1,142 @@
+#include <stdlib.h>
+#include <pthread.h>
+#include <unistd.h>
+#include "threadpool.h"
+
+// One worker's share of the task range, padded to its own cache line so
+// workers popping their own slices don't false-share
+typedef struct {
+    pthread_mutex_t lock;
+    size_t begin;           // Next task to run
+    size_t end;             // One past the last task owned
+    char pad[64];
+} pool_slice_t;
+
+typedef struct {
+    pool_slice_t *slices;
+    int workers;
+    pool_task_fn fn;
+    void *ctx;
+} pool_t;
+
+typedef struct {
+    pool_t *pool;
+    int id;
+} pool_worker_t;
+
+int pool_default_workers(void) {
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    return cpus > 0 ? (int)cpus : 1;
+}
+
+// Takes the next task from the worker's own slice
+static int pool_pop(pool_slice_t *slice, size_t *task) {
+    int found = 0;
+    pthread_mutex_lock(&slice->lock);
+    if (slice->begin < slice->end) {
+        *task = slice->begin++;
+        found = 1;
+    }
+    pthread_mutex_unlock(&slice->lock);
+    return found;
+}
+
+// Moves the back half of the fullest other slice into 'self'
+static int pool_steal(pool_t *pool, int self) {
+    for (;;) {
+        int victim = -1;
+        size_t most = 0;
+
+        // The sizes may change right after they are read; the transfer below
+        // re-checks under the victim's lock
+        for (int w = 0; w < pool->workers; w++) {
+            if (w == self) continue;
+            pthread_mutex_lock(&pool->slices[w].lock);
+            size_t left = pool->slices[w].end - pool->slices[w].begin;
+            pthread_mutex_unlock(&pool->slices[w].lock);
+            if (left > most) {
+                most = left;
+                victim = w;
+            }
+        }
+        if (victim < 0) return 0;
+
+        pool_slice_t *v = &pool->slices[victim];
+        size_t begin = 0, end = 0;
+        pthread_mutex_lock(&v->lock);
+        if (v->begin < v->end) {
+            size_t left = v->end - v->begin;
+            end = v->end;
+            begin = v->end - (left + 1) / 2;
+            v->end = begin;
+        }
+        pthread_mutex_unlock(&v->lock);
+        if (begin == end) continue; // Lost the race, look again
+
+        pool_slice_t *s = &pool->slices[self];
+        pthread_mutex_lock(&s->lock);
+        s->begin = begin;
+        s->end = end;
+        pthread_mutex_unlock(&s->lock);
+        return 1;
+    }
+}
+
+static void *pool_worker_main(void *arg) {
+    pool_worker_t *w = arg;
+    pool_t *pool = w->pool;
+    size_t task;
+
+    do {
+        while (pool_pop(&pool->slices[w->id], &task)) {
+            pool->fn(pool->ctx, w->id, task);
+        }
+    } while (pool_steal(pool, w->id));
+
+    return NULL;
+}
+
+int pool_run(int workers, size_t tasks, pool_task_fn fn, void *ctx) {
+    if (workers <= 0) workers = pool_default_workers();
+    if ((size_t)workers > tasks) workers = tasks > 0 ? (int)tasks : 1;
+
+    pool_t pool = { calloc(workers, sizeof(pool_slice_t)), workers, fn, ctx };
+    pthread_t *threads = calloc(workers, sizeof(pthread_t));
+    pool_worker_t *ids = calloc(workers, sizeof(pool_worker_t));
+    if (!pool.slices || !threads || !ids) {
+        free(pool.slices);
+        free(threads);
+        free(ids);
+        return -1;
+    }
+
+    // Initial even split of the task range
+    for (int w = 0; w < workers; w++) {
+        pthread_mutex_init(&pool.slices[w].lock, NULL);
+        pool.slices[w].begin = tasks * w / workers;
+        pool.slices[w].end = tasks * (w + 1) / workers;
+        ids[w].pool = &pool;
+        ids[w].id = w;
+    }
+
+    // Worker 0 is the calling thread. If a thread fails to start, its slice
+    // is simply left for the others to steal.
+    int started = 1;
+    for (int w = 1; w < workers; w++) {
+        if (pthread_create(&threads[w], NULL, pool_worker_main, &ids[w]) == 0) started++;
+        else threads[w] = pthread_self();
+    }
+    pool_worker_main(&ids[0]);
+
+    for (int w = 1; w < workers; w++) {
+        if (!pthread_equal(threads[w], pthread_self())) pthread_join(threads[w], NULL);
+    }
+    for (int w = 0; w < workers; w++) {
+        pthread_mutex_destroy(&pool.slices[w].lock);
+    }
+
+    free(ids);
+    free(threads);
+    free(pool.slices);
+    return started;
+}
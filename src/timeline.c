@@ -0,0 +1,71 @@
+#include "scheduler.h"
+
+void timeline_init(timeline_t *timeline) {
+    timeline->events = NULL;
+    timeline->count = 0;
+    timeline->capacity = 0;
+    timeline->published = 0;
+    timeline->observer = NULL;
+    timeline->observer_ctx = NULL;
+}
+
+void timeline_free(timeline_t *timeline) {
+    free(timeline->events);
+    timeline_init(timeline);
+}
+
+void timeline_clear(timeline_t *timeline) {
+    timeline->count = 0;
+    timeline->published = 0;
+}
+
+void timeline_observe(timeline_t *timeline, timeline_observer_fn observer, void *ctx) {
+    timeline->observer = observer;
+    timeline->observer_ctx = ctx;
+}
+
+int timeline_reserve(timeline_t *timeline, size_t capacity) {
+    if (capacity <= timeline->capacity) return 0;
+
+    timeline_event_t *events = realloc(timeline->events, capacity * sizeof(timeline_event_t));
+    if (!events) return -1;
+
+    timeline->events = events;
+    timeline->capacity = capacity;
+    return 0;
+}
+
+int timeline_append(timeline_t *timeline, int time, int pid, int duration) {
+    return timeline_append_cpu(timeline, 0, time, pid, duration);
+}
+
+int timeline_append_cpu(timeline_t *timeline, int cpu, int time, int pid, int duration) {
+    if (duration <= 0) return 0;
+
+    if (timeline->count > 0) {
+        timeline_event_t *last = &timeline->events[timeline->count - 1];
+        if (last->pid == pid && last->cpu == cpu && last->time + last->duration == time) {
+            last->duration += duration;
+            return 0;
+        }
+    }
+
+    // Grow geometrically so appends stay amortized O(1)
+    if (timeline->count == timeline->capacity) {
+        size_t grown = timeline->capacity ? timeline->capacity * 2 : 64;
+        if (timeline_reserve(timeline, grown) != 0) return -1;
+    }
+
+    timeline_event_t *e = &timeline->events[timeline->count++];
+    e->time = time;
+    e->pid = pid;
+    e->duration = duration;
+    e->cpu = cpu;
+
+    if (timeline->observer && timeline->count - timeline->published > TIMELINE_CHUNK) {
+        int stop = timeline->observer(timeline->observer_ctx, timeline);
+        timeline->published = timeline->count - 1;
+        if (stop) return -1;
+    }
+    return 0;
+}
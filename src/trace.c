@@ -0,0 +1,337 @@
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "trace.h"
+
+// Encoded bytes gathered before each fwrite
+#define TRACE_BUFFER (64 * 1024)
+
+// Longest encoding of one event: four 64-bit varints
+#define TRACE_EVENT_MAX 40
+
+static uint64_t zigzag(int64_t v) {
+    return ((uint64_t)v << 1) ^ (uint64_t)(v >> 63);
+}
+
+static int64_t unzigzag(uint64_t v) {
+    return (int64_t)(v >> 1) ^ -(int64_t)(v & 1);
+}
+
+static size_t put_varint(uint8_t *out, uint64_t v) {
+    size_t n = 0;
+    while (v >= 0x80) {
+        out[n++] = (uint8_t)(v | 0x80);
+        v >>= 7;
+    }
+    out[n++] = (uint8_t)v;
+    return n;
+}
+
+// Reads a varint at *offset, stopping at 'limit'. Returns 0, or -1 if it runs
+// past the end.
+static int get_varint(const uint8_t *data, uint64_t limit, uint64_t *offset, uint64_t *v) {
+    uint64_t result = 0;
+    for (int shift = 0; shift < 64 && *offset < limit; shift += 7) {
+        uint8_t byte = data[(*offset)++];
+        result |= (uint64_t)(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) {
+            *v = result;
+            return 0;
+        }
+    }
+    return -1;
+}
+
+static size_t padding(uint64_t bytes) {
+    return (size_t)((8 - bytes % 8) % 8);
+}
+
+// ------------------------------------------------------
+// Writer
+// ------------------------------------------------------
+
+int trace_writer_open(trace_writer_t *w, const char *path) {
+    memset(w, 0, sizeof(*w));
+    w->file = fopen(path, "wb");
+    if (!w->file) {
+        perror(path);
+        return -1;
+    }
+    w->buffer = malloc(TRACE_BUFFER);
+
+    // A zeroed header marks the file incomplete until trace_writer_close
+    trace_header_t header = {0};
+    if (!w->buffer || fwrite(&header, sizeof(header), 1, w->file) != 1) {
+        perror(path);
+        fclose(w->file);
+        free(w->buffer);
+        return -1;
+    }
+    return 0;
+}
+
+static int flush_buffer(trace_writer_t *w) {
+    if (w->buffered > 0 && fwrite(w->buffer, 1, w->buffered, w->file) != w->buffered) w->failed = 1;
+    w->buffered = 0;
+    return w->failed ? -1 : 0;
+}
+
+static int encode(trace_writer_t *w, const timeline_event_t *e) {
+    uint32_t stride = TRACE_STRIDE;
+    size_t entry = (size_t)(w->count / stride);
+
+    if (w->count % stride == 0) {
+        if (entry == w->index_capacity) {
+            size_t grown = w->index_capacity ? w->index_capacity * 2 : 64;
+            trace_index_t *index = realloc(w->index, grown * sizeof(trace_index_t));
+            if (!index) {
+                w->failed = 1;
+                return -1;
+            }
+            w->index = index;
+            w->index_capacity = grown;
+        }
+        w->index[entry].offset = w->data_bytes;
+        w->index[entry].time = e->time;
+        w->prev_end = 0;
+        w->prev_pid = 0;
+    }
+
+    if (w->buffered + TRACE_EVENT_MAX > TRACE_BUFFER && flush_buffer(w) != 0) return -1;
+
+    int64_t end = (int64_t)e->time + e->duration;
+    size_t start = w->buffered;
+    w->buffered += put_varint(w->buffer + w->buffered, zigzag((int64_t)e->time - w->prev_end));
+    w->buffered += put_varint(w->buffer + w->buffered, zigzag((int64_t)e->pid - w->prev_pid));
+    w->buffered += put_varint(w->buffer + w->buffered, (uint64_t)e->duration);
+    w->buffered += put_varint(w->buffer + w->buffered, (uint64_t)e->cpu);
+    w->data_bytes += w->buffered - start;
+
+    w->prev_end = end;
+    w->prev_pid = e->pid;
+    if (e->time < w->index[entry].time) w->index[entry].time = e->time;
+    if ((uint32_t)e->cpu >= w->cpus) w->cpus = (uint32_t)e->cpu + 1;
+    if (w->count == 0 || end > w->end_time) w->end_time = end;
+    w->index[entry].end = (int32_t)w->end_time;
+    w->count++;
+    return 0;
+}
+
+int trace_writer_append(trace_writer_t *w, const timeline_event_t *e) {
+    if (w->failed) return -1;
+    if (e->duration <= 0) return 0;
+
+    timeline_event_t *p = &w->pending;
+    if (w->has_pending && p->pid == e->pid && p->cpu == e->cpu && p->time + p->duration == e->time) {
+        p->duration += e->duration;
+        return 0;
+    }
+    if (w->has_pending && encode(w, p) != 0) return -1;
+    *p = *e;
+    w->has_pending = 1;
+    return 0;
+}
+
+int trace_writer_sync(trace_writer_t *w, const timeline_t *timeline, int final) {
+    size_t upto = timeline->count;
+    if (!final && upto > 0) upto--;
+
+    for (; w->synced < upto; w->synced++) {
+        if (trace_writer_append(w, &timeline->events[w->synced]) != 0) return -1;
+    }
+    return 0;
+}
+
+int trace_writer_observer(void *ctx, const timeline_t *timeline) {
+    // A failed write does not stop the simulation; close reports it
+    trace_writer_sync(ctx, timeline, 0);
+    return 0;
+}
+
+int trace_writer_close(trace_writer_t *w) {
+    if (w->has_pending) encode(w, &w->pending);
+    flush_buffer(w);
+
+    static const uint8_t zeros[8] = {0};
+    size_t entries = (size_t)((w->count + TRACE_STRIDE - 1) / TRACE_STRIDE);
+    size_t pad = padding(w->data_bytes);
+
+    // Each entry's time becomes the earliest start from that entry on
+    for (size_t k = entries; k-- > 1;) {
+        if (w->index[k].time < w->index[k - 1].time) w->index[k - 1].time = w->index[k].time;
+    }
+    if (fwrite(zeros, 1, pad, w->file) != pad ||
+        (entries > 0 && fwrite(w->index, sizeof(trace_index_t), entries, w->file) != entries)) {
+        w->failed = 1;
+    }
+
+    trace_header_t header = {
+        .version = TRACE_VERSION,
+        .stride = TRACE_STRIDE,
+        .count = w->count,
+        .data_bytes = w->data_bytes,
+        .index_count = entries,
+        .end_time = w->end_time,
+        .cpus = w->cpus,
+    };
+    memcpy(header.magic, TRACE_MAGIC, sizeof(header.magic));
+    if (fseek(w->file, 0, SEEK_SET) != 0 || fwrite(&header, sizeof(header), 1, w->file) != 1) {
+        w->failed = 1;
+    }
+    if (fclose(w->file) != 0) w->failed = 1;
+    if (w->failed) perror("trace");
+
+    int result = w->failed ? -1 : 0;
+    free(w->buffer);
+    free(w->index);
+    memset(w, 0, sizeof(*w));
+    return result;
+}
+
+// ------------------------------------------------------
+// Reader
+// ------------------------------------------------------
+
+int trace_open(const char *path, trace_t *trace) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        perror(path);
+        return -1;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        perror(path);
+        close(fd);
+        return -1;
+    }
+    if ((size_t)st.st_size < sizeof(trace_header_t)) {
+        fprintf(stderr, "%s: too short for a trace\n", path);
+        close(fd);
+        return -1;
+    }
+
+    void *base = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd); // The mapping keeps the file referenced
+    if (base == MAP_FAILED) {
+        perror(path);
+        return -1;
+    }
+
+    const trace_header_t *h = base;
+    size_t room = st.st_size - sizeof(trace_header_t);
+    int valid = memcmp(h->magic, TRACE_MAGIC, sizeof(h->magic)) == 0 &&
+                h->version == TRACE_VERSION && h->stride > 0 &&
+                h->data_bytes <= room && h->count <= SIZE_MAX &&
+                h->index_count == (h->count + h->stride - 1) / h->stride;
+    if (valid) {
+        room -= h->data_bytes + padding(h->data_bytes);
+        valid = h->index_count <= room / sizeof(trace_index_t);
+    }
+    if (!valid) {
+        fprintf(stderr, "%s: not a complete version %d trace\n", path, TRACE_VERSION);
+        munmap(base, st.st_size);
+        return -1;
+    }
+
+    // The Gantt view jumps around the file
+    madvise(base, st.st_size, MADV_RANDOM);
+
+    const uint8_t *data = (const uint8_t *)base + sizeof(trace_header_t);
+    trace->header = h;
+    trace->data = data;
+    trace->index = (const trace_index_t *)(data + h->data_bytes + padding(h->data_bytes));
+    trace->count = (size_t)h->count;
+    trace->end_time = (int)h->end_time;
+    trace->cpus = (int)h->cpus;
+    trace->base = base;
+    trace->length = st.st_size;
+    return 0;
+}
+
+void trace_close(trace_t *trace) {
+    if (trace->base) munmap(trace->base, trace->length);
+    memset(trace, 0, sizeof(*trace));
+}
+
+void trace_seek(trace_cursor_t *c, const trace_t *trace, size_t event) {
+    uint32_t stride = trace->header->stride;
+
+    c->trace = trace;
+    if (event >= trace->count) {
+        c->next = trace->count;
+        c->offset = trace->header->data_bytes;
+        return;
+    }
+
+    const trace_index_t *entry = &trace->index[event / stride];
+    c->next = event - event % stride;
+    c->offset = entry->offset;
+    c->prev_end = 0;
+    c->prev_pid = 0;
+
+    timeline_event_t skipped;
+    while (c->next < event && trace_next(c, &skipped)) {}
+}
+
+int trace_next(trace_cursor_t *c, timeline_event_t *e) {
+    const trace_t *trace = c->trace;
+    uint64_t limit = trace->header->data_bytes;
+    uint64_t gap, pid, duration, cpu;
+
+    if (c->next >= trace->count) return 0;
+    if (c->next % trace->header->stride == 0) {
+        c->prev_end = 0;
+        c->prev_pid = 0;
+    }
+    if (get_varint(trace->data, limit, &c->offset, &gap) != 0 ||
+        get_varint(trace->data, limit, &c->offset, &pid) != 0 ||
+        get_varint(trace->data, limit, &c->offset, &duration) != 0 ||
+        get_varint(trace->data, limit, &c->offset, &cpu) != 0) {
+        c->next = trace->count;
+        return 0;
+    }
+
+    e->time = (int)(c->prev_end + unzigzag(gap));
+    e->pid = (int)(c->prev_pid + unzigzag(pid));
+    e->duration = (int)duration;
+    e->cpu = (int)cpu;
+    c->prev_end = (int64_t)e->time + e->duration;
+    c->prev_pid = e->pid;
+    c->next++;
+    return 1;
+}
+
+size_t trace_find(const trace_t *trace, double time) {
+    // The first entry whose events reach past 'time' holds the answer
+    size_t lo = 0, hi = (size_t)trace->header->index_count;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (trace->index[mid].end > time) hi = mid;
+        else lo = mid + 1;
+    }
+    if (lo == trace->header->index_count) return trace->count;
+
+    trace_cursor_t c;
+    timeline_event_t e;
+    trace_seek(&c, trace, lo * trace->header->stride);
+    while (trace_next(&c, &e)) {
+        if (e.time + e.duration > time) return c.next - 1;
+    }
+    return trace->count;
+}
+
+int trace_next_overlapping(trace_cursor_t *c, double start, double end, timeline_event_t *e) {
+    const trace_t *trace = c->trace;
+    uint32_t stride = trace->header->stride;
+
+    while (c->next < trace->count) {
+        // Nothing from this entry on starts before 'end'
+        if (c->next % stride == 0 && trace->index[c->next / stride].time >= end) return 0;
+        if (!trace_next(c, e)) return 0;
+        if (e->time < end && e->time + e->duration > start) return 1;
+    }
+    return 0;
+}
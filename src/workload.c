@@ -0,0 +1,334 @@
+#include <string.h>
+#include <ctype.h>
+#include <limits.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "workload.h"
+
+// Parses up to 4 integers from a line; returns how many were read
+static int parse_fields(const char *line, long fields[4]) {
+    int count = 0;
+    const char *s = line;
+
+    while (*s && count < 4) {
+        while (*s == ' ' || *s == '\t' || *s == ',') s++;
+        if (*s == '\0' || *s == '\n' || *s == '\r') break;
+
+        char *end;
+        fields[count] = strtol(s, &end, 10);
+        if (end == s) return -1; // Not a number
+        count++;
+        s = end;
+    }
+    return count;
+}
+
+// Reads one line into 'line' like fgets. The rest of a line that does not
+// fit is consumed and *truncated set, so its tail is never read as a line of
+// its own.
+static char *read_line(char *line, int size, FILE *f, int *truncated) {
+    if (!fgets(line, size, f)) return NULL;
+    *truncated = 0;
+    if (strchr(line, '\n')) return line;
+
+    // A line that exactly fills the buffer is complete if its end follows
+    int c = getc(f);
+    if (c == '\r') c = getc(f);
+    if (c == EOF || c == '\n') return line;
+
+    *truncated = 1;
+    while (c != EOF && c != '\n') c = getc(f);
+    return line;
+}
+
+// Classifies one text line: 1 = record in fields[] (each fits in an int),
+// 0 = skip, -1 = error.
+// A line that does not start with a number is only accepted as a header
+// before the first record.
+// Comments may be any length; other lines must fit the read buffer.
+static int parse_line(const char *path, int line_no, const char *line, int truncated, int have_records,
+                      long fields[4]) {
+    const char *s = line;
+    while (isspace((unsigned char)*s)) s++;
+    if (*s == '#') return 0;
+
+    if (truncated) {
+        fprintf(stderr, "%s:%d: line too long\n", path, line_no);
+        return -1;
+    }
+    if (*s == '\0') return 0;
+
+    fields[0] = fields[1] = fields[2] = fields[3] = 0;
+    int count = parse_fields(s, fields);
+    int numeric = isdigit((unsigned char)*s) || *s == '-' || *s == '+';
+    if (count < 0 && !have_records && !numeric) return 0; // Header row
+    if (count < 3) {
+        fprintf(stderr, "%s:%d: expected 'pid arrival burst [priority]'\n", path, line_no);
+        return -1;
+    }
+    for (int i = 0; i < count; i++) {
+        if (fields[i] < INT_MIN || fields[i] > INT_MAX) {
+            fprintf(stderr, "%s:%d: value out of range\n", path, line_no);
+            return -1;
+        }
+    }
+    if (fields[1] < 0 || fields[2] < 0) {
+        fprintf(stderr, "%s:%d: arrival and burst must be non-negative\n", path, line_no);
+        return -1;
+    }
+    return 1;
+}
+
+int workload_parse_line(const char *source, int line_no, const char *line, int have_records,
+                        workload_record_t *r) {
+    long fields[4];
+    int kind = parse_line(source, line_no, line, 0, have_records, fields);
+    if (kind == 1) {
+        *r = (workload_record_t){(int32_t)fields[0], (int32_t)fields[1], (int32_t)fields[2], (int32_t)fields[3]};
+    }
+    return kind;
+}
+
+void workload_reset(process_t *processes, int n) {
+    for (int i = 0; i < n; i++) {
+        processes[i].remaining_time = processes[i].burst_time;
+        processes[i].start_time = 0;
+        processes[i].completion_time = 0;
+        processes[i].turnaround_time = 0;
+        processes[i].waiting_time = 0;
+        processes[i].response_time = 0;
+    }
+}
+
+// Text loader: grows the array geometrically while reading
+static int load_text(const char *path, process_t **out) {
+    FILE *f = fopen(path, "r");
+    if (!f) {
+        perror(path);
+        return -1;
+    }
+
+    process_t *processes = NULL;
+    int n = 0;
+    int capacity = 0;
+    int line_no = 0;
+    char line[256];
+
+    int truncated;
+
+    while (read_line(line, sizeof(line), f, &truncated)) {
+        long fields[4];
+        int kind = parse_line(path, ++line_no, line, truncated, n > 0, fields);
+        if (kind < 0) goto fail;
+        if (kind == 0) continue;
+
+        if (n == capacity) {
+            int grown = capacity ? capacity * 2 : 256;
+            process_t *p = realloc(processes, sizeof(process_t) * grown);
+            if (!p) {
+                fprintf(stderr, "%s: out of memory after %d processes\n", path, n);
+                goto fail;
+            }
+            processes = p;
+            capacity = grown;
+        }
+
+        process_t *p = &processes[n++];
+        p->pid = (int)fields[0];
+        p->arrival_time = (int)fields[1];
+        p->burst_time = (int)fields[2];
+        p->priority = (int)fields[3];
+    }
+
+    fclose(f);
+    workload_reset(processes, n);
+    *out = processes;
+    return n;
+
+fail:
+    fclose(f);
+    free(processes);
+    return -1;
+}
+
+int workload_load(const char *path, process_t **out) {
+    char magic[8] = {0};
+    FILE *f = fopen(path, "rb");
+    if (!f) {
+        perror(path);
+        return -1;
+    }
+    size_t got = fread(magic, 1, sizeof(magic), f);
+    fclose(f);
+
+    if (got < sizeof(magic) || memcmp(magic, WORKLOAD_MAGIC, sizeof(magic)) != 0) {
+        return load_text(path, out);
+    }
+
+    workload_map_t map;
+    if (workload_map(path, &map) != 0) return -1;
+    int n = workload_from_records(map.records, map.count, out);
+    if (n < 0) fprintf(stderr, "%s: out of memory for %zu processes\n", path, map.count);
+    workload_unmap(&map);
+    return n;
+}
+
+// ------------------------------------------------------
+// Binary format
+// ------------------------------------------------------
+
+int workload_map(const char *path, workload_map_t *map) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        perror(path);
+        return -1;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        perror(path);
+        close(fd);
+        return -1;
+    }
+    if ((size_t)st.st_size < sizeof(workload_header_t)) {
+        fprintf(stderr, "%s: too short for a binary workload\n", path);
+        close(fd);
+        return -1;
+    }
+
+    void *base = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd); // The mapping keeps the file referenced
+    if (base == MAP_FAILED) {
+        perror(path);
+        return -1;
+    }
+
+    const workload_header_t *h = base;
+    size_t max_records = (st.st_size - sizeof(workload_header_t)) / sizeof(workload_record_t);
+    if (memcmp(h->magic, WORKLOAD_MAGIC, sizeof(h->magic)) != 0 ||
+        h->version != WORKLOAD_VERSION ||
+        h->record_size != sizeof(workload_record_t) ||
+        h->count > max_records || h->count > INT_MAX) {
+        fprintf(stderr, "%s: not a valid version %d binary workload\n", path, WORKLOAD_VERSION);
+        munmap(base, st.st_size);
+        return -1;
+    }
+
+    // Records are consumed front to back
+    madvise(base, st.st_size, MADV_SEQUENTIAL);
+
+    // Same rule as the text loader: a negative burst would never finish
+    const workload_record_t *records =
+        (const workload_record_t *)((const char *)base + sizeof(workload_header_t));
+    for (size_t i = 0; i < h->count; i++) {
+        if (records[i].arrival_time < 0 || records[i].burst_time < 0) {
+            fprintf(stderr, "%s: record %zu: arrival and burst must be non-negative\n", path, i + 1);
+            munmap(base, st.st_size);
+            return -1;
+        }
+    }
+
+    map->base = base;
+    map->length = st.st_size;
+    map->records = records;
+    map->count = h->count;
+    return 0;
+}
+
+void workload_unmap(workload_map_t *map) {
+    if (map->base) munmap(map->base, map->length);
+    map->base = NULL;
+    map->records = NULL;
+    map->count = 0;
+    map->length = 0;
+}
+
+int workload_from_records(const workload_record_t *records, size_t count, process_t **out) {
+    process_t *processes = malloc(sizeof(process_t) * (count > 0 ? count : 1));
+    if (!processes) return -1;
+
+    for (size_t i = 0; i < count; i++) {
+        process_t *p = &processes[i];
+        p->pid = records[i].pid;
+        p->arrival_time = records[i].arrival_time;
+        p->burst_time = records[i].burst_time;
+        p->priority = records[i].priority;
+    }
+    workload_reset(processes, (int)count);
+    *out = processes;
+    return (int)count;
+}
+
+long long workload_convert(const char *text_path, const char *bin_path) {
+    FILE *in = fopen(text_path, "r");
+    if (!in) {
+        perror(text_path);
+        return -1;
+    }
+    FILE *out = fopen(bin_path, "wb");
+    if (!out) {
+        perror(bin_path);
+        fclose(in);
+        return -1;
+    }
+
+    // Large stdio buffers keep the syscall count low; memory use stays fixed
+    size_t buf_size = 1 << 20;
+    char *in_buf = malloc(buf_size);
+    char *out_buf = malloc(buf_size);
+    if (in_buf) setvbuf(in, in_buf, _IOFBF, buf_size);
+    if (out_buf) setvbuf(out, out_buf, _IOFBF, buf_size);
+
+    // Placeholder header; the count is patched in once the input is drained
+    workload_header_t header;
+    memcpy(header.magic, WORKLOAD_MAGIC, sizeof(header.magic));
+    header.version = WORKLOAD_VERSION;
+    header.record_size = sizeof(workload_record_t);
+    header.count = 0;
+
+    long long count = 0;
+    int line_no = 0;
+    int ok = fwrite(&header, sizeof(header), 1, out) == 1;
+    char line[256];
+    int truncated;
+
+    while (ok && read_line(line, sizeof(line), in, &truncated)) {
+        long fields[4];
+        int kind = parse_line(text_path, ++line_no, line, truncated, count > 0, fields);
+        if (kind < 0) {
+            ok = 0;
+            break;
+        }
+        if (kind == 0) continue;
+
+        workload_record_t r = {(int32_t)fields[0], (int32_t)fields[1], (int32_t)fields[2], (int32_t)fields[3]};
+        ok = fwrite(&r, sizeof(r), 1, out) == 1;
+        if (!ok) perror(bin_path);
+        count++;
+    }
+    if (ok && ferror(in)) {
+        perror(text_path);
+        ok = 0;
+    }
+
+    header.count = (uint64_t)count;
+    if (ok) {
+        ok = fseek(out, 0, SEEK_SET) == 0 && fwrite(&header, sizeof(header), 1, out) == 1;
+        if (!ok) perror(bin_path);
+    }
+    if (fclose(out) != 0 && ok) {
+        perror(bin_path);
+        ok = 0;
+    }
+    fclose(in);
+    free(out_buf);
+    free(in_buf);
+
+    if (!ok) {
+        remove(bin_path);
+        return -1;
+    }
+    return count;
+}
@@ -0,0 +1,56 @@
+#include "workload_gen.h"
+#include "workload.h"
+#include "rng.h"
+
+void workload_default_spec(workload_spec_t *spec, int n, uint64_t seed) {
+    spec->n = n;
+    spec->arrivals = ARRIVAL_POISSON;
+    spec->arrival_rate = 0.09;
+    spec->storm_size = 50;
+    spec->bursts = BURST_EXPONENTIAL;
+    spec->burst_mean = 10;
+    spec->pareto_alpha = 1.5;
+    spec->max_burst = 1000000;
+    spec->priority_levels = 5;
+    spec->seed = seed;
+}
+
+static int draw_burst(const workload_spec_t *spec, rng_t *rng) {
+    double burst = spec->bursts == BURST_PARETO
+        ? rng_pareto(rng, spec->burst_mean, spec->pareto_alpha)
+        : rng_exponential(rng, spec->burst_mean);
+
+    // Round up so every job needs at least one tick
+    int b = (int)ceil(burst < spec->max_burst ? burst : spec->max_burst);
+    return b > 0 ? b : 1;
+}
+
+void workload_generate(const workload_spec_t *spec, process_t *out) {
+    rng_t rng;
+    rng_seed(&rng, spec->seed);
+
+    double clock = 0;
+    int storm_left = 0;
+    int levels = spec->priority_levels > 0 ? spec->priority_levels : 1;
+
+    for (int i = 0; i < spec->n; i++) {
+        if (spec->arrivals == ARRIVAL_BURSTY) {
+            // A new storm starts after a quiet gap long enough to keep the
+            // same average rate; its jobs all arrive together
+            if (storm_left == 0) {
+                clock += rng_exponential(&rng, spec->storm_size / spec->arrival_rate);
+                storm_left = 1 + (int)rng_exponential(&rng, spec->storm_size - 1);
+            }
+            storm_left--;
+        } else if (i > 0) {
+            clock += rng_exponential(&rng, 1.0 / spec->arrival_rate);
+        }
+
+        process_t *p = &out[i];
+        p->pid = i + 1;
+        p->arrival_time = (int)clock;
+        p->burst_time = draw_burst(spec, &rng);
+        p->priority = (int)rng_below(&rng, levels);
+    }
+    workload_reset(out, spec->n);
+}
@@ -0,0 +1,80 @@
+// Fenwick tree test: random weight updates, with prefix sums and
+// fenwick_find checked against a linear scan of a plain weight array, across
+// fenwick_reserve growth. Run with make test.
+#include <stdio.h>
+#include <stdlib.h>
+#include "fenwick.h"
+
+#define MAX_SLOTS 1500
+#define ROUNDS 400
+
+static int failures = 0;
+
+static void fail(const char *what, int round) {
+    if (failures++ < 10) printf("FAIL %s in round %d\n", what, round);
+}
+
+// Sum of slots [0, slot), read straight off the 1-based partial sums
+static long long prefix(const fenwick_t *f, int slot) {
+    long long sum = 0;
+    for (int i = slot; i > 0; i -= i & -i) sum += f->tree[i];
+    return sum;
+}
+
+static void check(const fenwick_t *f, const long long *weight, int slots, int round) {
+    long long sum = 0;
+    for (int s = 0; s <= slots; s++) {
+        if (prefix(f, s) != sum) {
+            fail("prefix sum", round);
+            return;
+        }
+        if (s < slots) sum += weight[s];
+    }
+    if (fenwick_total(f) != sum) fail("total", round);
+
+    // Each slot owns [prefix, prefix + weight); probe both ends and a middle
+    long long start = 0;
+    for (int s = 0; s < slots; s++) {
+        long long w = weight[s];
+        if (w > 0 && (fenwick_find(f, start) != s || fenwick_find(f, start + w - 1) != s ||
+                      fenwick_find(f, start + w / 2) != s)) {
+            fail("find", round);
+            return;
+        }
+        start += w;
+    }
+}
+
+int main(void) {
+    static long long weight[MAX_SLOTS];
+    fenwick_t f;
+    int slots = 5;
+
+    if (fenwick_init(&f, slots, NULL) != 0) return 1;
+    srand(1);
+
+    for (int round = 0; round < ROUNDS; round++) {
+        // Grow now and then, as lottery does when jobs arrive
+        if (round % 40 == 39 && slots * 3 <= MAX_SLOTS) {
+            slots *= 3;
+            if (fenwick_reserve(&f, slots) != 0) return 1;
+        }
+
+        for (int k = 0; k < 50; k++) {
+            int s = rand() % slots;
+            // Mostly small weights, some zeroed, some large
+            long long w = rand() % 4 == 0 ? 0 : rand() % 8 == 0 ? 1000000 + rand() : rand() % 10;
+            fenwick_add(&f, s, w - weight[s]);
+            weight[s] = w;
+        }
+        check(&f, weight, slots, round);
+    }
+
+    fenwick_free(&f);
+    if (failures) {
+        printf("%d failure(s)\n", failures);
+        return 1;
+    }
+    printf("Fenwick tree matches a linear scan over %d rounds, up to %d slots\n", ROUNDS, slots);
+    return 0;
+}
@@ -0,0 +1,104 @@
+// Red-black tree test: random inserts and erases checked against a plain
+// membership array, with the tree's shape and colors validated as it goes.
+// Run with make test.
+#include <stdio.h>
+#include <stdlib.h>
+#include "rbtree.h"
+
+#define ITEMS 2000
+#define STEPS 200000
+
+static int failures = 0;
+static int key[ITEMS];
+
+static int by_key(const void *ctx, int a, int b) {
+    (void)ctx;
+    return key[a] != key[b] ? key[a] < key[b] : a < b;
+}
+
+static void fail(const char *what, int step) {
+    if (failures++ < 10) printf("FAIL %s after step %d\n", what, step);
+}
+
+// Black height of the subtree at 'x', or -1 if a red-black rule is broken
+// below it
+static int black_height(const rb_nodes_t *nd, int x) {
+    if (x == nd->nil) return 1;
+    int l = nd->left[x], r = nd->right[x];
+    if (l != nd->nil && (nd->parent[l] != x || by_key(NULL, x, l))) return -1;
+    if (r != nd->nil && (nd->parent[r] != x || by_key(NULL, r, x))) return -1;
+    if (nd->red[x] && (nd->red[l] || nd->red[r])) return -1;
+
+    int hl = black_height(nd, l), hr = black_height(nd, r);
+    if (hl < 0 || hl != hr) return -1;
+    return hl + !nd->red[x];
+}
+
+// Compares the tree with the items marked in 'member': size, leftmost, the
+// in-order walk, and the red-black invariants
+static void check(const rb_nodes_t *nd, const rbtree_t *tree, const unsigned char *member, int step) {
+    int expected = 0, first = -1;
+    for (int i = 0; i < ITEMS; i++) {
+        if (!member[i]) continue;
+        expected++;
+        if (first < 0 || by_key(NULL, i, first)) first = i;
+    }
+    if (tree->size != expected) fail("size", step);
+    if (rbtree_first(tree) != first) fail("leftmost", step);
+
+    int walked = 0, prev = -1;
+    for (int x = rbtree_first(tree); x >= 0 && walked <= expected; x = rbtree_next(nd, x)) {
+        if (!member[x]) fail("walk visits an erased item", step);
+        if (prev >= 0 && !by_key(NULL, prev, x)) fail("walk out of order", step);
+        prev = x;
+        walked++;
+    }
+    if (walked != expected) fail("walk length", step);
+
+    if (tree->root != nd->nil && (nd->red[tree->root] || nd->parent[tree->root] != nd->nil)) {
+        fail("root", step);
+    }
+    if (nd->red[nd->nil]) fail("sentinel turned red", step);
+    if (black_height(nd, tree->root) < 0) fail("red-black invariant", step);
+}
+
+int main(void) {
+    rb_nodes_t nodes;
+    rbtree_t tree;
+    unsigned char member[ITEMS] = {0};
+
+    if (rb_nodes_init(&nodes, ITEMS, by_key, NULL, NULL) != 0) return 1;
+    rbtree_init(&nodes, &tree);
+    srand(1);
+
+    for (int step = 0; step < STEPS; step++) {
+        int item = rand() % ITEMS;
+        if (member[item]) {
+            rbtree_erase(&nodes, &tree, item);
+            member[item] = 0;
+        } else {
+            // Few distinct keys, so ties are broken on the index often
+            key[item] = rand() % 64;
+            rbtree_insert(&nodes, &tree, item);
+            member[item] = 1;
+        }
+        if (step % 97 == 0 || step < 1000) check(&nodes, &tree, member, step);
+    }
+
+    // Drain it in order through the leftmost node
+    for (int step = STEPS; tree.size > 0; step++) {
+        int x = rbtree_first(&tree);
+        rbtree_erase(&nodes, &tree, x);
+        member[x] = 0;
+        if (step % 17 == 0) check(&nodes, &tree, member, step);
+    }
+    check(&nodes, &tree, member, -1);
+
+    rb_nodes_free(&nodes);
+    if (failures) {
+        printf("%d failure(s)\n", failures);
+        return 1;
+    }
+    printf("Red-black tree matches the oracle over %d operations\n", STEPS);
+    return 0;
+}
@@ -0,0 +1,138 @@
+// Differential test for incremental re-simulation: after editing one job,
+// sim_session_rerun must give exactly what a fresh run of the edited
+// workload gives, for every policy. Run with make test.
+#include <stdio.h>
+#include <string.h>
+#include "checkpoint.h"
+#include "policy.h"
+#include "workload_gen.h"
+
+typedef struct {
+    int arrival;            // New arrival, or -1 to keep it
+    int burst;              // New burst, or -1 to keep it
+} edit_t;
+
+static int failures = 0;
+static int reruns = 0;
+static int resumed = 0;     // Reruns that started from a snapshot
+
+static int same_run(const proc_table_t *a, const timeline_t *ta, const metrics_acc_t *aa, long ea,
+                    const proc_table_t *b, const timeline_t *tb, const metrics_acc_t *ab, long eb) {
+    size_t bytes = sizeof(int) * a->n;
+    return ea == eb && ea >= 0 &&
+           memcmp(ta->events, tb->events, sizeof(timeline_event_t) * ta->count) == 0 &&
+           memcmp(a->start_time, b->start_time, bytes) == 0 &&
+           memcmp(a->completion_time, b->completion_time, bytes) == 0 &&
+           aa->count == ab->count && aa->total_turnaround == ab->total_turnaround &&
+           aa->total_waiting == ab->total_waiting && aa->total_response == ab->total_response &&
+           aa->max_completion == ab->max_completion && aa->sum_sq_turnaround == ab->sum_sq_turnaround &&
+           memcmp(&aa->turnaround, &ab->turnaround, sizeof(histogram_t)) == 0 &&
+           memcmp(&aa->response, &ab->response, sizeof(histogram_t)) == 0;
+}
+
+// Runs 'processes' once through a session, applies each edit in turn to row
+// 'idx', and checks every rerun against a fresh run
+static void check(const char *name, const sim_params_t *params, const process_t *processes, int n,
+                  int idx, const edit_t *edits, int edit_count) {
+    proc_table_t a, b;
+    timeline_t ta, tb;
+    metrics_acc_t aa, ab;
+    sim_session_t s;
+
+    if (proc_table_from_array(&a, processes, n) != 0 || proc_table_init(&b, n) != 0) {
+        fprintf(stderr, "out of memory\n");
+        failures++;
+        return;
+    }
+    timeline_init(&ta);
+    timeline_init(&tb);
+    sim_session_init(&s, params);
+    metrics_acc_init(&aa);
+    sim_session_run(&s, &a, &ta, &aa);
+
+    for (int e = 0; e < edit_count; e++) {
+        if (edits[e].arrival >= 0) a.arrival_time[idx] = edits[e].arrival;
+        if (edits[e].burst >= 0) a.burst_time[idx] = edits[e].burst;
+
+        int resumed_at;
+        long ea = sim_session_rerun(&s, &a, idx, &ta, &aa, &resumed_at);
+        reruns++;
+        if (resumed_at > 0) resumed++;
+
+        proc_table_copy_inputs(&b, &a);
+        metrics_acc_init(&ab);
+        long eb = schedule_params_table(params, &b, NULL, &tb, &ab);
+
+        if (!same_run(&a, &ta, &aa, ea, &b, &tb, &ab, eb)) {
+            printf("FAIL %s policy %d, edit %d (arrival %d, burst %d), resumed at %d\n", name,
+                   params->policy, e, a.arrival_time[idx], a.burst_time[idx], resumed_at);
+            failures++;
+        }
+    }
+
+    sim_session_free(&s);
+    timeline_free(&ta);
+    timeline_free(&tb);
+    proc_table_free(&a);
+    proc_table_free(&b);
+}
+
+int main(void) {
+    int quantums[] = {2, 4, 8};
+    mlfq_config_t mlfq = {3, quantums, 50};
+
+    // Two long jobs and a late short one, moved to well before the end of
+    // the snapshots taken while the long ones run
+    process_t late[3] = {
+        {.pid = 1, .arrival_time = 0, .burst_time = 5000},
+        {.pid = 2, .arrival_time = 0, .burst_time = 5000},
+        {.pid = 3, .arrival_time = 20000, .burst_time = 5},
+    };
+    edit_t late_edits[] = {{100, -1}, {9000, -1}, {9000, 40}, {30000, -1}, {0, -1}};
+
+    // Generated workloads, edited at a row in the middle
+    int n = 20000;
+    process_t *generated = malloc(sizeof(process_t) * n);
+    if (!generated) return 1;
+
+    for (int policy = SIM_FIFO; policy < SIM_POLICY_COUNT; policy++) {
+        sim_params_t params = {
+            .policy = (sim_policy_t)policy,
+            .quantum = policy == SIM_RR ? 1 : 3,
+            .mlfq = &mlfq,
+            .seed = 7,
+            .aging_interval = 7,
+        };
+        check("late", &params, late, 3, 2, late_edits, sizeof(late_edits) / sizeof(late_edits[0]));
+
+        for (int seed = 1; seed <= 3; seed++) {
+            workload_spec_t spec;
+            workload_default_spec(&spec, n, seed);
+            if (seed == 2) spec.arrivals = ARRIVAL_BURSTY;
+            workload_generate(&spec, generated);
+
+            int idx = n / 2;
+            int arrival = generated[idx].arrival_time;
+            edit_t edits[] = {
+                {arrival / 2, -1},          // Much earlier
+                {arrival - 1, -1},          // Just earlier
+                {-1, 1},                    // Burst only
+                {arrival + arrival / 4, 3}, // Later, with a new burst
+                {0, -1},                    // To the start
+            };
+            check("generated", &params, generated, n, idx, edits, sizeof(edits) / sizeof(edits[0]));
+        }
+    }
+
+    free(generated);
+    if (resumed == 0) {
+        printf("FAIL no rerun resumed from a snapshot\n");
+        failures++;
+    }
+    if (failures) {
+        printf("%d failure(s)\n", failures);
+        return 1;
+    }
+    printf("All %d reruns match a fresh run (%d resumed from a snapshot)\n", reruns, resumed);
+    return 0;
+}
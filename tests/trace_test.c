@@ -0,0 +1,210 @@
+// Trace file test: write/read round-trips through the varint encoding and the
+// seek index, and window queries on a multi-core trace whose events are not
+// in start order, checked against a brute-force scan. Run with make test.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "trace.h"
+
+#define CPUS 4
+#define SLICES 20000    // Many strides, so the index is exercised
+
+static int failures = 0;
+static char path[] = "/tmp/trace_test_XXXXXX";
+
+static void fail(const char *what, long detail) {
+    if (failures++ < 10) printf("FAIL %s (%ld)\n", what, detail);
+}
+
+static int write_trace(const timeline_event_t *events, size_t n) {
+    trace_writer_t w;
+    if (trace_writer_open(&w, path) != 0) return -1;
+    for (size_t i = 0; i < n; i++) trace_writer_append(&w, &events[i]);
+    return trace_writer_close(&w);
+}
+
+static int same_event(const timeline_event_t *a, const timeline_event_t *b) {
+    return a->time == b->time && a->pid == b->pid && a->duration == b->duration && a->cpu == b->cpu;
+}
+
+// Every event reads back in order, and seeking to any event lands on it
+static void check_round_trip(const timeline_event_t *events, size_t n, const char *name) {
+    trace_t trace;
+    if (write_trace(events, n) != 0 || trace_open(path, &trace) != 0) {
+        fail(name, 0);
+        return;
+    }
+    if (trace.count != n) fail("event count", (long)trace.count);
+
+    trace_cursor_t c;
+    timeline_event_t e;
+    size_t i = 0;
+    trace_seek(&c, &trace, 0);
+    while (trace_next(&c, &e)) {
+        if (i >= n || !same_event(&e, &events[i])) {
+            fail("round trip", (long)i);
+            break;
+        }
+        i++;
+    }
+    if (i != n) fail("events read back", (long)i);
+
+    for (int k = 0; k < 1000 && n > 0; k++) {
+        size_t at = (size_t)rand() % n;
+        trace_seek(&c, &trace, at);
+        if (!trace_next(&c, &e) || !same_event(&e, &events[at])) fail("seek", (long)at);
+    }
+    trace_close(&trace);
+}
+
+static int by_end(const void *a, const void *b) {
+    const timeline_event_t *x = a, *y = b;
+    int xe = x->time + x->duration, ye = y->time + y->duration;
+    return xe != ye ? (xe > ye) - (xe < ye) : x->cpu - y->cpu;
+}
+
+// Slices of CPUS cores in the order a multi-core run writes them: each
+// slice when its core finishes it, so starts go backwards across cores
+static size_t multicore_events(timeline_event_t *events) {
+    int clock[CPUS] = {0};
+    for (size_t i = 0; i < SLICES; i++) {
+        int cpu = 0;
+        for (int c = 1; c < CPUS; c++) {
+            if (clock[c] < clock[cpu]) cpu = c;
+        }
+        // The gap keeps a core's slices from touching, so none merge
+        int start = clock[cpu] + 1 + rand() % 5;
+        // A rare long slice ends several strides after it starts
+        int shape = rand() % 2000;
+        int duration = 1 + (shape == 0 ? 5000 + rand() % 20000 : shape < 200 ? rand() % 400 : rand() % 20);
+        events[i] = (timeline_event_t){.time = start, .duration = duration, .pid = 1 + rand() % 1000,
+                                       .cpu = cpu};
+        clock[cpu] = start + duration;
+    }
+    qsort(events, SLICES, sizeof(timeline_event_t), by_end);
+    return SLICES;
+}
+
+static void check_windows(const timeline_event_t *events, size_t n) {
+    trace_t trace;
+    if (write_trace(events, n) != 0 || trace_open(path, &trace) != 0) {
+        fail("multi-core trace", 0);
+        return;
+    }
+    if (trace.cpus != CPUS) fail("cpu count", trace.cpus);
+
+    int backwards = 0;
+    for (size_t i = 1; i < n; i++) backwards += events[i].time < events[i - 1].time;
+    if (backwards == 0) fail("test trace is in start order", 0);
+
+    for (int k = 0; k < 2000; k++) {
+        int start = rand() % (trace.end_time + 20) - 10;
+        int end = start + 1 + (k % 4 == 0 ? rand() % 2000 : rand() % 30);
+
+        // First event in file order that ends after 'start'
+        size_t first = n;
+        for (size_t i = 0; i < n && first == n; i++) {
+            if (events[i].time + events[i].duration > start) first = i;
+        }
+        size_t found = trace_find(&trace, start);
+        if (found != first) fail("trace_find", start);
+
+        long expected = 0, listed = 0;
+        for (size_t i = 0; i < n; i++) {
+            expected += events[i].time < end && events[i].time + events[i].duration > start;
+        }
+        trace_cursor_t c;
+        timeline_event_t e;
+        trace_seek(&c, &trace, found);
+        while (trace_next_overlapping(&c, start, end, &e)) {
+            if (e.time >= end || e.time + e.duration <= start) fail("event outside the window", start);
+            listed++;
+        }
+        if (listed != expected) fail("events in window", start);
+    }
+    trace_close(&trace);
+}
+
+int main(void) {
+    int fd = mkstemp(path);
+    if (fd < 0) {
+        perror("mkstemp");
+        return 1;
+    }
+    close(fd);
+    srand(1);
+
+    // Falling pids and idle gaps give negative and positive deltas, and
+    // large values need multi-byte varints
+    timeline_event_t simple[] = {
+        {.time = 0, .duration = 3, .pid = 900, .cpu = 0},
+        {.time = 3, .duration = 1, .pid = 2, .cpu = 0},
+        {.time = 10, .duration = 70000, .pid = -5, .cpu = 0},
+        {.time = 70010, .duration = 2, .pid = 2000000000, .cpu = 1},
+        {.time = 2000000000, .duration = 7, .pid = 1, .cpu = 4095},
+    };
+    check_round_trip(simple, sizeof(simple) / sizeof(simple[0]), "simple trace");
+
+    timeline_event_t *events = malloc(sizeof(timeline_event_t) * SLICES);
+    if (!events) return 1;
+    size_t n = multicore_events(events);
+    check_round_trip(events, n, "multi-core trace");
+    check_windows(events, n);
+
+    // Back-to-back slices of one process on one core merge
+    timeline_event_t split[] = {
+        {.time = 0, .duration = 2, .pid = 1, .cpu = 0},
+        {.time = 2, .duration = 3, .pid = 1, .cpu = 0},
+        {.time = 5, .duration = 1, .pid = 1, .cpu = 1},
+    };
+    timeline_event_t merged[] = {
+        {.time = 0, .duration = 5, .pid = 1, .cpu = 0},
+        {.time = 5, .duration = 1, .pid = 1, .cpu = 1},
+    };
+    trace_t trace;
+    timeline_event_t e;
+    trace_cursor_t c;
+    if (write_trace(split, 3) != 0 || trace_open(path, &trace) != 0) {
+        fail("merge trace", 0);
+    } else {
+        size_t i = 0;
+        trace_seek(&c, &trace, 0);
+        while (trace_next(&c, &e)) {
+            if (i >= 2 || !same_event(&e, &merged[i])) fail("merge", (long)i);
+            i++;
+        }
+        if (i != 2) fail("merged count", (long)i);
+        trace_close(&trace);
+    }
+
+    // An empty run gives a readable trace; an unfinished one is refused
+    if (write_trace(NULL, 0) != 0 || trace_open(path, &trace) != 0) {
+        fail("empty trace", 0);
+    } else {
+        trace_seek(&c, &trace, trace_find(&trace, 0));
+        if (trace.count != 0 || trace_next_overlapping(&c, 0, 10, &e)) fail("empty trace contents", 0);
+        trace_close(&trace);
+    }
+    trace_writer_t w;
+    if (trace_writer_open(&w, path) == 0) {
+        trace_writer_append(&w, &simple[0]);
+        fflush(w.file);
+        printf("(an incomplete-trace error is expected next)\n");
+        fflush(stdout);
+        if (trace_open(path, &trace) == 0) {
+            fail("unfinished trace accepted", 0);
+            trace_close(&trace);
+        }
+        trace_writer_close(&w);
+    }
+
+    free(events);
+    unlink(path);
+    if (failures) {
+        printf("%d failure(s)\n", failures);
+        return 1;
+    }
+    printf("Traces round-trip, and %d windows over %d cores match a full scan\n", 2000, CPUS);
+    return 0;
+}